@@ -0,0 +1,292 @@
+#include <cstdio> // for printf family
+#include <cstdlib> // for EXIT_SUCCESS definition
+#include <cstdint>
+#include <cstring>
+
+#include <sys/mman.h>
+
+#include "libperf.h"
+#include "libperf_bench.hpp"
+
+/**
+ * @brief Benchmarks of libperf's own overhead: initialisation, reads, logging & toggles
+ * @note Software events are used throughout, so these run in VMs without a PMU; the rdpmc path on a hardware counter is only measured if one can be opened
+ * @author Salih MSA
+ */
+
+namespace {
+
+	const std::uint64_t software = LIBPERF_EVENT_MASK(LIBPERF_EVENT_SW_CPU_CLOCK) | LIBPERF_EVENT_MASK(LIBPERF_EVENT_SW_CONTEXT_SWITCHES) | LIBPERF_EVENT_MASK(LIBPERF_EVENT_SW_PAGE_FAULTS) ;
+	const libperf_event members[] = { LIBPERF_EVENT_SW_CPU_CLOCK, LIBPERF_EVENT_SW_CONTEXT_SWITCHES, LIBPERF_EVENT_SW_PAGE_FAULTS } ;
+	const std::size_t member_count = sizeof(members) / sizeof(members[0]) ;
+
+	/* trackers benchmarks operate on, opened (and enabled) by main() */
+	libperf_tracker* counters = nullptr ; // counters of `software`, opened individually
+	libperf_tracker* group = nullptr ; // `members`, as a group
+	libperf_tracker* rdpmc = nullptr ; // `software`, in rdpmc read mode, which software events fall back from
+	libperf_tracker* hardware = nullptr ; // HW instructions, in rdpmc read mode, if available
+	std::FILE* sink = nullptr ; // where libperf_log() writes to
+
+} // anonymous
+
+static void init_fini_default(std::uint64_t iterations)
+{
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_tracker *const pd = libperf_init(0, -1) ;
+		if(pd != nullptr)
+		{
+			libperf_fini(pd) ;
+		}
+	}
+}
+LIBPERF_BENCHMARK(init_fini_default) ;
+
+static void init_fini_selective(std::uint64_t iterations)
+{
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_tracker *const pd = libperf_init_selective(0, -1, software, LIBPERF_INIT_DEFAULT) ;
+		if(pd != nullptr)
+		{
+			libperf_fini(pd) ;
+		}
+	}
+}
+LIBPERF_BENCHMARK(init_fini_selective) ;
+
+static void read_counter(std::uint64_t iterations)
+{
+	std::uint64_t value = 0 ;
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_read_counter(counters, LIBPERF_EVENT_SW_CPU_CLOCK, &value) ;
+		libperf::do_not_optimize(value) ;
+	}
+}
+LIBPERF_BENCHMARK(read_counter) ;
+
+static void read_counter_scaled(std::uint64_t iterations)
+{
+	libperf_counter_value value ;
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_read_counter_scaled(counters, LIBPERF_EVENT_SW_CPU_CLOCK, &value) ;
+		libperf::do_not_optimize(value) ;
+	}
+}
+LIBPERF_BENCHMARK(read_counter_scaled) ;
+
+static void read_counter_rdpmc_fallback(std::uint64_t iterations)
+{
+	std::uint64_t value = 0 ;
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_read_counter(rdpmc, LIBPERF_EVENT_SW_CPU_CLOCK, &value) ;
+		libperf::do_not_optimize(value) ;
+	}
+}
+LIBPERF_BENCHMARK(read_counter_rdpmc_fallback) ;
+
+static void read_group(std::uint64_t iterations)
+{
+	std::uint64_t values[member_count] ;
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_read_group(group, values) ;
+		libperf::do_not_optimize(values) ;
+	}
+}
+LIBPERF_BENCHMARK(read_group) ;
+
+static void read_group_scaled(std::uint64_t iterations)
+{
+	libperf_counter_value values[member_count] ;
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_read_group_scaled(group, values) ;
+		libperf::do_not_optimize(values) ;
+	}
+}
+LIBPERF_BENCHMARK(read_group_scaled) ;
+
+static void read_enabled(std::uint64_t iterations)
+{
+	std::uint64_t events = 0 ;
+	std::uint64_t values[LIBPERF_EVENT_SLOTS] ;
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_read_enabled(counters, &events, values) ;
+		libperf::do_not_optimize(values) ;
+	}
+}
+LIBPERF_BENCHMARK(read_enabled) ;
+
+static void log_all(std::uint64_t iterations)
+{
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_log(counters, sink, static_cast<std::size_t>(i)) ;
+	}
+}
+LIBPERF_BENCHMARK(log_all) ;
+
+static void toggle_counter_off_on(std::uint64_t iterations)
+{
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_toggle_counter(counters, LIBPERF_EVENT_SW_CPU_CLOCK, LIBPERF_EVENT_TOGGLE_OFF) ;
+		libperf_toggle_counter(counters, LIBPERF_EVENT_SW_CPU_CLOCK, LIBPERF_EVENT_TOGGLE_ON) ;
+	}
+}
+LIBPERF_BENCHMARK(toggle_counter_off_on) ;
+
+static void toggle_counters_group_off_on(std::uint64_t iterations)
+{
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_toggle_counters(group, software, LIBPERF_EVENT_TOGGLE_OFF) ;
+		libperf_toggle_counters(group, software, LIBPERF_EVENT_TOGGLE_ON) ;
+	}
+}
+LIBPERF_BENCHMARK(toggle_counters_group_off_on) ;
+
+static void toggle_process_off_on(std::uint64_t iterations)
+{
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_toggle_process(LIBPERF_EVENT_TOGGLE_OFF) ;
+		libperf_toggle_process(LIBPERF_EVENT_TOGGLE_ON) ;
+	}
+}
+LIBPERF_BENCHMARK(toggle_process_off_on) ;
+
+static void read_counter_rdpmc_hardware(std::uint64_t iterations)
+{
+	std::uint64_t value = 0 ;
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		libperf_read_counter(hardware, LIBPERF_EVENT_HW_INSTRUCTIONS, &value) ;
+		libperf::do_not_optimize(value) ;
+	}
+}
+
+/**
+ * @brief fault_pages - maps, touches & unmaps fresh pages, so every iteration page faults
+ * @note Not a benchmark, but the function checked_harness() measures
+ */
+static void fault_pages(std::uint64_t iterations)
+{
+	static const std::size_t pages = 16 ;
+	static const std::size_t page = 4096 ;
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		void *const mapping = mmap(nullptr, pages * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) ;
+		if(mapping == MAP_FAILED)
+		{
+			continue ;
+		}
+		for(std::size_t p = 0 ; p < pages ; ++p)
+		{
+			static_cast<volatile char*>(mapping)[p * page] = 1 ;
+		}
+		munmap(mapping, pages * page) ;
+	}
+}
+
+/**
+ * @brief checked_harness - checks every member of the harness' group counts, not only its leader, by measuring page faults on fault_pages()
+ * @param const libperf::Bench::Options& options - options benchmarks are run with, whose last event is page faults
+ * @return bool - false if the page faults member didn't advance
+ */
+static bool checked_harness(const libperf::Bench::Options& options)
+{
+	libperf::Bench::Options check = options ;
+	check.samples = 3 ;
+	check.warmup_ns = 0 ;
+
+	libperf::Bench::Result result ;
+	return libperf::Bench::run("fault_pages", fault_pages, check, result) && result.event_count == check.event_count && result.counters[check.event_count - 1].median > 0.0 ;
+}
+
+int main(int argc, char** argv)
+{
+	libperf::Bench::Options options ;
+	options.events[0] = LIBPERF_EVENT_SW_CPU_CLOCK ; // harness' own counters are software too
+	options.events[1] = LIBPERF_EVENT_SW_CONTEXT_SWITCHES ;
+	options.events[2] = LIBPERF_EVENT_SW_PAGE_FAULTS ;
+	options.event_count = 3 ;
+
+	for(int i = 1 ; i < argc ; ++i)
+	{
+		if(std::strcmp(argv[i], "--csv") == 0)
+		{
+			options.format = libperf::Bench::Format::CSV ;
+		}
+		else if(std::strcmp(argv[i], "--json") == 0)
+		{
+			options.format = libperf::Bench::Format::JSON ;
+		}
+		else if(std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+		{
+			options.filter = argv[++i] ;
+		}
+		else {
+			std::fprintf(stderr, "usage: %s [--csv | --json] [--filter substring]\n", argv[0]) ;
+			return EXIT_FAILURE ;
+		}
+	}
+
+	libperf_set_diag_sink(NULL, NULL) ; // unsupported counters (e.g. without a PMU) would otherwise be logged on every init
+
+	counters = libperf_init_selective(0, -1, software, LIBPERF_INIT_DEFAULT) ;
+	group = libperf_init_group(0, -1, members, member_count) ;
+	rdpmc = libperf_init_selective(0, -1, software, LIBPERF_INIT_DEFAULT) ;
+	sink = std::fopen("/dev/null", "w") ;
+	if(counters == nullptr || group == nullptr || rdpmc == nullptr || sink == nullptr)
+	{
+		std::perror("unable to set up benchmarks") ;
+		return EXIT_FAILURE ;
+	}
+	libperf_toggle_counters(counters, software, LIBPERF_EVENT_TOGGLE_ON) ;
+	libperf_toggle_counters(group, software, LIBPERF_EVENT_TOGGLE_ON) ;
+	libperf_toggle_counters(rdpmc, software, LIBPERF_EVENT_TOGGLE_ON) ;
+	libperf_set_read_mode(rdpmc, LIBPERF_READ_MODE_RDPMC) ;
+
+	if(!checked_harness(options))
+	{
+		std::fprintf(stderr, "harness counters other than the group leader don't count, so results would be wrong\n") ;
+		return EXIT_FAILURE ;
+	}
+
+	const std::size_t failed = libperf::Bench::run_all(options, stdout) ;
+
+	hardware = libperf_init_selective(0, -1, LIBPERF_EVENT_MASK(LIBPERF_EVENT_HW_INSTRUCTIONS), LIBPERF_INIT_DEFAULT) ;
+	if(hardware != nullptr && libperf_toggle_counter(hardware, LIBPERF_EVENT_HW_INSTRUCTIONS, LIBPERF_EVENT_TOGGLE_ON) == LIBPERF_EXIT_SUCCESS && libperf_set_read_mode(hardware, LIBPERF_READ_MODE_RDPMC) == LIBPERF_EXIT_SUCCESS)
+	{
+		libperf::Bench::Result result ;
+		if((options.filter == nullptr || std::strstr("read_counter_rdpmc_hardware", options.filter) != nullptr) && libperf::Bench::run("read_counter_rdpmc_hardware", read_counter_rdpmc_hardware, options, result))
+		{
+			libperf::Bench::report(stdout, result, options.format) ;
+		}
+	}
+	else {
+		std::fprintf(stderr, "no hardware counters, so rdpmc reads of them weren't measured\n") ;
+	}
+
+	if(hardware != nullptr)
+	{
+		libperf_fini(hardware) ;
+	}
+	libperf_fini(rdpmc) ;
+	libperf_fini(group) ;
+	libperf_fini(counters) ;
+	std::fclose(sink) ;
+
+	if(failed != 0)
+	{
+		std::fprintf(stderr, "%zu benchmarks couldn't be measured\n", failed) ;
+	}
+
+	return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
@@ -0,0 +1,61 @@
+#include <cstdio> // for printf family
+#include <cstdlib> // for EXIT_SUCCESS definition
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "libperf_bench.hpp"
+
+/**
+ * @brief Example benchmarks using the libperf microbenchmark harness
+ * @author Salih MSA
+ */
+
+static void sum_sequential(std::uint64_t iterations)
+{
+	static std::vector<std::uint32_t> data(1 << 16, 1) ;
+
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		std::uint64_t sum = 0 ;
+		for(const std::uint32_t value : data)
+		{
+			sum += value ;
+		}
+		libperf::do_not_optimize(sum) ;
+	}
+}
+LIBPERF_BENCHMARK(sum_sequential) ;
+
+static void sum_strided(std::uint64_t iterations)
+{
+	static std::vector<std::uint32_t> data(1 << 20, 1) ;
+
+	for(std::uint64_t i = 0 ; i < iterations ; ++i)
+	{
+		std::uint64_t sum = 0 ;
+		for(std::size_t j = 0 ; j < data.size() ; j += 16) // one element per cache line
+		{
+			sum += data[j] ;
+		}
+		libperf::do_not_optimize(sum) ;
+	}
+}
+LIBPERF_BENCHMARK(sum_strided) ;
+
+int main(int argc, char** argv)
+{
+	libperf::Bench::Options options ;
+	if(argc > 1 && std::strcmp(argv[1], "--csv") == 0)
+	{
+		options.format = libperf::Bench::Format::CSV ;
+	}
+
+	const std::size_t failed = libperf::Bench::run_all(options, stdout) ;
+	if(failed != 0)
+	{
+		std::fprintf(stderr, "%zu benchmarks couldn't be measured\n", failed) ;
+	}
+
+	return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE ;
+}
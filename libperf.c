@@ -10,17 +10,20 @@
 #include <stdarg.h>
 
 #include <errno.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
 #include <sys/syscall.h>
 #include <sys/stat.h>
-#include <syslog.h> 
 
 #include <linux/perf_event.h>
 #include <linux/hw_breakpoint.h>
 
 #include "libperf.h"
+#include "libperf_diag.h"
 
 /**
  * @brief Definitions of libperf API and inner functionality
@@ -29,9 +32,8 @@
 
 #define LIBPERF_MAX_COUNTERS 33 // number of perf counters
 				// this excludes any special library counters
-#define LIBPERF_ADDITIONAL_COUNTERS 1
 
-static const char *libperf_event_name[LIBPERF_MAX_COUNTERS + LIBPERF_ADDITIONAL_COUNTERS] = {
+static const char *libperf_event_names[LIBPERF_EVENT_SLOTS] = {
 	/* index using enum to get event name */
 	/* sw tracepoints */
 	"SW_CPU_CLOCK",
@@ -84,7 +86,12 @@ static const char *libperf_event_name[LIBPERF_MAX_COUNTERS + LIBPERF_ADDITIONAL_
 	"HW_CACHE_BPU_LOADS_MISSES",
 
 	/** Special internally defined counter **/
-	"SW_WALL_TIME"
+	"SW_WALL_TIME",
+
+	/** Caller-defined events **/
+	"CUSTOM_0", "CUSTOM_1", "CUSTOM_2", "CUSTOM_3", "CUSTOM_4", "CUSTOM_5", "CUSTOM_6", "CUSTOM_7", "CUSTOM_8", "CUSTOM_9",
+	"CUSTOM_10", "CUSTOM_11", "CUSTOM_12", "CUSTOM_13", "CUSTOM_14", "CUSTOM_15", "CUSTOM_16", "CUSTOM_17", "CUSTOM_18", "CUSTOM_19",
+	"CUSTOM_20", "CUSTOM_21", "CUSTOM_22", "CUSTOM_23", "CUSTOM_24", "CUSTOM_25", "CUSTOM_26", "CUSTOM_27", "CUSTOM_28", "CUSTOM_29"
 };
 
 static struct perf_event_attr default_attrs[LIBPERF_MAX_COUNTERS] = { // detailed configuration information for the event being created
@@ -127,11 +134,20 @@ static struct perf_event_attr default_attrs[LIBPERF_MAX_COUNTERS] = { // detaile
 };
 
 struct libperf_tracker { /* lib struct */
-	int group; // who's the group leader (or -1 if you are)
+	int group; // fd of the group leader (or -1 if every counter is its own leader)
 	struct perf_event_attr *attrs; // list of events & their attributes. we will also use this to keep track of configuration information
 	pid_t id; // process or thread ID
 	int cpu; // CPU (or CPUs) to track
-	int fds[LIBPERF_MAX_COUNTERS]; // set of counters
+	unsigned long open_flags; // flags counters are opened with (PERF_FLAG_PID_CGROUP if id is a cgroup's fd)
+	int fds[LIBPERF_EVENT_SLOTS]; // set of counters, indexed by enum libperf_event (caller-defined events included)
+	uint64_t ids[LIBPERF_EVENT_SLOTS]; // kernel-assigned event IDs, used to match up values of a group read
+	enum libperf_event members[LIBPERF_EVENT_SLOTS]; // events of the group, in the order the user declared them
+	size_t members_count; // number of events in the group (0 if ungrouped)
+	struct perf_event_mmap_page *pages[LIBPERF_EVENT_SLOTS]; // user pages of counters, mapped for rdpmc reads (NULL if unmapped)
+	enum libperf_read_mode read_mode; // how counters are read, so lazily opened counters can be set up to match
+	uint64_t pending; // mask of selected counters whose opening is deferred until first toggled; only written under lock, read atomically
+	uint64_t enabled; // mask of counters currently enabled; only written under lock, read atomically so readers never block
+	pthread_mutex_t lock; // serialises toggles, which may open lazy counters
 	double wall_start; // for time profiling, get abs time when logging started
 };
 
@@ -146,151 +162,905 @@ static inline double rdclock(void)
 	return (double)ts.tv_sec + ((double)ts.tv_nsec / 1000000000);
 }
 
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief rdpmc - reads a hardware performance counter directly from userspace
+ * @param const uint32_t counter - index of hardware counter (ie perf_event_mmap_page::index - 1)
+ * @return uint64_t - raw, unextended counter value
+ */
+static inline uint64_t rdpmc(const uint32_t counter)
+{
+	uint32_t low, high;
+	__asm__ volatile("rdpmc" : "=a" (low), "=d" (high) : "c" (counter));
+	return ((uint64_t)high << 32) | low;
+}
+
+/**
+ * @brief rdtsc - reads the time stamp counter
+ * @return uint64_t - cycles since reset
+ */
+static inline uint64_t rdtsc(void)
+{
+	uint32_t low, high;
+	__asm__ volatile("rdtsc" : "=a" (low), "=d" (high));
+	return ((uint64_t)high << 32) | low;
+}
+#endif
+
+/**
+ * @brief libperf_read_page - reads a counter through its user page, following the seqlock protocol described in linux/perf_event.h
+ * @param const volatile struct perf_event_mmap_page *const pc - user page of counter
+ * @param struct libperf_counter_value *const value - value to write raw count (and times, if requested) out to
+ * @param const bool timed - whether to also compute enabled & running times up to now
+ * @return bool - false if the counter can't be read from userspace at the moment (not on a PMU, rdpmc disallowed or unsupported architecture), in which case a read() is needed
+ */
+static inline bool libperf_read_page(const volatile struct perf_event_mmap_page *const pc, struct libperf_counter_value *const value, const bool timed)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	uint32_t seq;
+
+	do {
+		seq = pc->lock;
+		__asm__ volatile("" ::: "memory"); // kernel may update page under us, so stop the compiler caching any of it
+
+		const uint32_t index = pc->index;
+		if (!pc->cap_user_rdpmc || index == 0) { // software events, or hardware events not currently scheduled in
+			return false;
+		}
+
+		if (timed && !pc->cap_user_time) {
+			return false;
+		}
+
+		const uint16_t width = pc->pmc_width;
+		if (width == 0 || width > 64) {
+			return false;
+		}
+
+		const uint64_t pmc = rdpmc(index - 1) << (64 - width); // sign extend counter to full 64 bits
+		value->raw = (uint64_t)pc->offset + (uint64_t)((int64_t)pmc >> (64 - width));
+
+		if (timed) { // times in page are as of last schedule in, so add time elapsed since, converting from TSC cycles
+			const uint64_t cycles = rdtsc();
+			const uint16_t shift = pc->time_shift;
+			const uint64_t mult = pc->time_mult;
+			const uint64_t quot = cycles >> shift;
+			const uint64_t rem = cycles & (((uint64_t)1 << shift) - 1);
+			const uint64_t delta = pc->time_offset + (quot * mult) + ((rem * mult) >> shift);
+
+			value->time_enabled = pc->time_enabled + delta;
+			value->time_running = pc->time_running + delta; // index is non-zero, ie counter is running right now
+		}
+
+		__asm__ volatile("" ::: "memory");
+	} while (pc->lock != seq); // retry if kernel rescheduled counter mid-read
+
+	return true;
+#else
+	(void)pc;
+	(void)value;
+	(void)timed;
+	return false;
+#endif
+}
+
 static inline int sys_perf_event_open(struct perf_event_attr *const hw_event, const pid_t id, const int cpu, const int group_fd, const unsigned long flags)
 {
 	return (int)syscall(__NR_perf_event_open, hw_event, id, cpu, group_fd, flags);
 }
 
-libperf_tracker *libperf_init(const pid_t id, const int cpu)
+/**
+ * @brief libperf_alloc - allocates a tracker with no counters opened yet
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @param const int cpu - cpuid to track
+ * @return libperf_tracker* - allocated handle, or NULL if out of memory
+ */
+static libperf_tracker *libperf_alloc(const pid_t id, const int cpu)
 {
 	libperf_tracker *pd = malloc(sizeof(libperf_tracker));
 	if (pd == NULL) {
-		syslog(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", __func__);
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", __func__);
 		return NULL;
 	}
 
 	pd->group = -1;
+	pd->members_count = 0;
+	pd->read_mode = LIBPERF_READ_MODE_SYSCALL;
+	pd->pending = 0;
+	pd->enabled = 0;
 
-	for (size_t i = 0; i < LIBPERF_MAX_COUNTERS; ++i) {
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) {
 		pd->fds[i] = -1;
+		pd->ids[i] = 0;
+		pd->pages[i] = NULL;
 	}
 
 	pd->id = id;
 	pd->cpu = cpu;
+	pd->open_flags = 0;
 
-	pd->attrs = malloc(LIBPERF_MAX_COUNTERS * sizeof(struct perf_event_attr)); // create a space for local, configurable copy of the attributes of our counters
+	pd->attrs = calloc(LIBPERF_EVENT_SLOTS, sizeof(struct perf_event_attr)); // create a space for local, configurable copy of the attributes of our counters; caller-defined ones are filled in by libperf_init_explicit
 	if (pd->attrs == NULL) {
-		syslog(LOG_ERR, "libperf (in %s): unable to allocate memory for perf events attributes", __func__);
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for perf events attributes", __func__);
+		free(pd);
 		return NULL;
 	}
+	pthread_mutex_init(&pd->lock, NULL);
 
 	for (size_t i = 0; i < LIBPERF_MAX_COUNTERS; ++i) {
 		/* firstly, we are going to initialise fields, for every single counter perf offers
 		 * we will do so by copying over general data (counter stuff), then specifying additional fields
-		 * TODO at some point, we need to allow the extra fields (ie those which don't pertain to what events to track, but rather HOW the features are tracked) to be customised
-		 * this as it stands could be a default function, and then the described could be libperf_init_explicit or whatever where they give their own perf attributes
-		 * but that's for a later date, and would most likely require an additional struct or enum parameters (or some combination of the two)
+		 * callers wanting to customise how events are tracked describe them in full with libperf_init_explicit instead
 		 */
 		pd->attrs[i] = default_attrs[i]; // copy over general data
 		pd->attrs[i].size = sizeof(struct perf_event_attr); // specifics: we include this due to kernel backcompatibility issues
 		pd->attrs[i].inherit = 1; // specifics: children inherit being tracked
 		pd->attrs[i].disabled = 1; // specifics: disable counters by default
 		pd->attrs[i].enable_on_exec = 0; // specifics: do not enable counters due to exec* call
+		pd->attrs[i].read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING; // specifics: report how long counters were actually on the PMU, as the kernel multiplexes them when there are more than it has slots
 		if (pd->id != -1) { // if we aren't doing system wide analysis ...
 			// then disable measuring statistics of the linux kernel - this will allow operation on more restrictive system
 			// if we are, it's misleading to disable this information, and you'll simply need the correct permissions
 			pd->attrs[i].exclude_kernel = 1;
 			pd->attrs[i].exclude_hv = 1;
 		}
+	}
 
-		/* secondly, create event */
-		pd->fds[i] = sys_perf_event_open(&pd->attrs[i], pd->id, pd->cpu, pd->group, 0); // open event, albeit with no additional flags
-		if (pd->fds[i] < 0) {
-			if (errno == E2BIG || errno == EACCES || errno == EBADF || errno == EBUSY || errno == EFAULT || errno == EINTR || errno == EMFILE || errno == ENOSPC || errno == EOVERFLOW || errno == EPERM || errno == ESRCH) { // error types listed are those which are due to programmer error or runtime issues with system
-				syslog(LOG_ERR, "libperf (in %s): specified event #%lu is invalid thus aborting; refer to documentation & manual pages", __func__, i);
+	return pd;
+}
+
+/**
+ * @brief libperf_open_error_fatal - decides whether a failed perf_event_open() is down to the caller / runtime, rather than the hardware
+ * @param const int err - errno left by perf_event_open()
+ * @return bool - true if the error should abort initialisation
+ */
+static inline bool libperf_open_error_fatal(const int err)
+{
+	// error types listed are those which are due to programmer error or runtime issues with system
+	return err == E2BIG || err == EACCES || err == EBADF || err == EBUSY || err == EFAULT || err == EINTR || err == EMFILE || err == ENOSPC || err == EOVERFLOW || err == EPERM || err == ESRCH;
+}
+
+/**
+ * @brief libperf_unmap_pages - unmaps the user pages of every counter
+ * @param libperf_tracker *const pd - tracker whose pages to unmap
+ */
+static void libperf_unmap_pages(libperf_tracker *const pd)
+{
+	const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) {
+		if (pd->pages[i] != NULL) {
+			munmap(pd->pages[i], page_size);
+			pd->pages[i] = NULL;
+		}
+	}
+}
+
+/**
+ * @brief libperf_close_all - closes every opened counter of a tracker, then releases it
+ * @note errno is preserved, so callers can bail out of initialisation with it intact
+ * @param libperf_tracker *const pd - tracker to release
+ */
+static void libperf_close_all(libperf_tracker *const pd)
+{
+	const int err = errno;
+
+	libperf_unmap_pages(pd);
+
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) {
+		if (pd->fds[i] >= 0) {
+			close(pd->fds[i]);
+		}
+	}
+
+	pthread_mutex_destroy(&pd->lock);
+	free(pd->attrs);
+	free(pd);
+
+	errno = err;
+}
+
+/**
+ * @brief libperf_map_page - maps the user page of a counter, so it can be read with rdpmc
+ * @param libperf_tracker *const pd - tracker
+ * @param const size_t counter - (opened) counter whose page to map
+ */
+static void libperf_map_page(libperf_tracker *const pd, const size_t counter)
+{
+	void *const page = mmap(NULL, (size_t)sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, pd->fds[counter], 0);
+	if (page == MAP_FAILED) { // not fatal, as reads of this counter simply fall back to read()
+		libperf_diag(LOG_WARNING, "libperf (in %s): unable to map user page of counter '%lu', falling back to read()", __func__, counter);
+		return;
+	}
+	pd->pages[counter] = page;
+}
+
+/**
+ * @brief libperf_is_counter - checks an event is a perf counter, ie either a generic event or a caller-defined one, rather than a special library counter
+ * @param const enum libperf_event counter - counter type
+ * @return bool - whether it indexes a tracker's counters
+ */
+static inline bool libperf_is_counter(const enum libperf_event counter)
+{
+	return (counter >= 0 && counter < LIBPERF_MAX_COUNTERS) || (counter >= LIBPERF_EVENT_CUSTOM && counter < LIBPERF_EVENT_SLOTS);
+}
+
+/**
+ * @brief libperf_open_counter - opens a single, ungrouped counter of a tracker
+ * @param libperf_tracker *const pd - tracker
+ * @param const size_t counter - counter to open
+ * @return enum libperf_exit - LIBPERF_EXIT_SYSTEM_ERROR if the failure was down to the caller or runtime (see libperf_open_error_fatal), LIBPERF_EXIT_COUNTER_UNINITIALISABLE if the system simply doesn't support the event
+ */
+static enum libperf_exit libperf_open_counter(libperf_tracker *const pd, const size_t counter)
+{
+	pd->fds[counter] = sys_perf_event_open(&pd->attrs[counter], pd->id, pd->cpu, pd->group, pd->open_flags);
+	if (pd->fds[counter] < 0) {
+		if (libperf_open_error_fatal(errno)) {
+			libperf_diag(LOG_ERR, "libperf (in %s): specified event #%lu is invalid; refer to documentation & manual pages", __func__, counter);
+			return LIBPERF_EXIT_SYSTEM_ERROR;
+		} else { // for others, we print a warning and that's it
+			libperf_diag(LOG_WARNING, "libperf (in %s): Event #%lu unsupported but continuing; refer to documentation & manual pages", __func__, counter);
+			return LIBPERF_EXIT_COUNTER_UNINITIALISABLE;
+		}
+	}
+
+	if (pd->read_mode == LIBPERF_READ_MODE_RDPMC) {
+		libperf_map_page(pd, counter);
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+/**
+ * @brief libperf_open_member - opens the next member of a tracker's group, the first becoming its leader
+ * @param libperf_tracker *const pd - tracker
+ * @param const enum libperf_event counter - counter to open, whose attributes are already set
+ * @param const char *const caller - name of API function, for logging
+ * @return bool - whether member was opened, errno set otherwise
+ */
+static bool libperf_open_member(libperf_tracker *const pd, const enum libperf_event counter, const char *const caller)
+{
+	pd->attrs[counter].read_format |= PERF_FORMAT_GROUP | PERF_FORMAT_ID; // one read on any member yields the whole group
+
+	/* unlike libperf_init, every member must open: a partial group would silently defeat measuring over the same interval */
+	pd->fds[counter] = sys_perf_event_open(&pd->attrs[counter], pd->id, pd->cpu, pd->group, pd->open_flags);
+	if (pd->fds[counter] < 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): group member '%d' could not be opened thus aborting; refer to documentation & manual pages", caller, counter);
+		return false;
+	}
+
+	if (ioctl(pd->fds[counter], PERF_EVENT_IOC_ID, &pd->ids[counter]) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to obtain ID of group member '%d'", caller, counter);
+		return false;
+	}
+
+	if (pd->group == -1) { // first member leads the group
+		pd->group = pd->fds[counter];
+	}
+	pd->members[pd->members_count++] = counter;
+
+	return true;
+}
+
+const char *libperf_event_name(const enum libperf_event event)
+{
+	if (event < 0 || event >= LIBPERF_EVENT_SLOTS) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid perf event or special library counter '%d' supplied", __func__, event);
+		return NULL;
+	}
+
+	return libperf_event_names[event];
+}
+
+enum libperf_exit libperf_event_attr(const enum libperf_event event, struct perf_event_attr *const attr)
+{
+	if (event < 0 || event >= LIBPERF_MAX_COUNTERS) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid perf event counter '%d' supplied", __func__, event);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	*attr = default_attrs[event];
+	attr->size = sizeof(struct perf_event_attr);
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+libperf_tracker *libperf_init(const pid_t id, const int cpu)
+{
+	return libperf_init_selective(id, cpu, LIBPERF_EVENT_MASK_ALL, LIBPERF_INIT_DEFAULT);
+}
+
+libperf_tracker *libperf_init_selective(const pid_t id, const int cpu, const uint64_t events, const unsigned int flags)
+{
+	if ((flags & LIBPERF_INIT_LAZY) && (flags & LIBPERF_INIT_ENABLE_ON_EXEC)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): lazy counters can't be enabled on exec", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+	if ((flags & LIBPERF_INIT_CGROUP) && (id < 0 || cpu < 0)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): cgroups can only be tracked on a concrete CPU", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	libperf_tracker *pd = libperf_alloc(id, cpu);
+	if (pd == NULL) {
+		return NULL;
+	}
+	if (flags & LIBPERF_INIT_CGROUP) {
+		pd->open_flags |= PERF_FLAG_PID_CGROUP;
+	}
+
+	for (size_t i = 0; i < LIBPERF_MAX_COUNTERS; ++i) {
+		if ((events & LIBPERF_EVENT_MASK(i)) == 0) { // never asked for, so never opened
+			continue;
+		}
+
+		if (flags & LIBPERF_INIT_NO_INHERIT) {
+			pd->attrs[i].inherit = 0;
+		}
+		if (flags & LIBPERF_INIT_ENABLE_ON_EXEC) {
+			pd->attrs[i].enable_on_exec = 1;
+		}
+
+		if (flags & LIBPERF_INIT_LAZY) { // defer until first toggled
+			pd->pending |= LIBPERF_EVENT_MASK(i);
+			continue;
+		}
+
+		const enum libperf_exit rt = libperf_open_counter(pd, i);
+		if (rt == LIBPERF_EXIT_SYSTEM_ERROR) {
+			libperf_diag(LOG_ERR, "libperf (in %s): aborting initialisation", __func__);
+			libperf_close_all(pd);
+			return NULL;
+		} else if (rt == LIBPERF_EXIT_SUCCESS && (flags & LIBPERF_INIT_ENABLE_ON_EXEC)) {
+			pd->enabled |= LIBPERF_EVENT_MASK(i); // kernel enables it come exec, and reads before then simply yield 0
+		}
+	}
+
+	pd->wall_start = rdclock();
+
+	libperf_diag(LOG_INFO, "libperf (in %s): library initialised", __func__);
+	return pd;
+}
+
+libperf_tracker *libperf_init_group(const pid_t id, const int cpu, const enum libperf_event *const events, const size_t count)
+{
+	if (events == NULL || count == 0 || count > LIBPERF_MAX_COUNTERS) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid group of %lu events supplied", __func__, count);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	libperf_tracker *pd = libperf_alloc(id, cpu);
+	if (pd == NULL) {
+		return NULL;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		const enum libperf_event counter = events[i];
+		if (counter < 0 || counter >= LIBPERF_MAX_COUNTERS || pd->fds[counter] >= 0) { // special counters can't be grouped, and each member may only appear once
+			libperf_diag(LOG_ERR, "libperf (in %s): invalid or duplicate group member '%d' supplied", __func__, counter);
+			libperf_close_all(pd);
+			errno = EINVAL;
+			return NULL;
+		}
+
+		if (!libperf_open_member(pd, counter, __func__)) {
+			libperf_close_all(pd);
+			return NULL;
+		}
+	}
+
+	pd->wall_start = rdclock();
+
+	libperf_diag(LOG_INFO, "libperf (in %s): library initialised with a group of %lu events", __func__, count);
+	return pd;
+}
+
+libperf_tracker *libperf_init_explicit(const pid_t id, const int cpu, const struct perf_event_attr *const attrs, const size_t count, const unsigned int flags)
+{
+	if (attrs == NULL || count == 0 || count > LIBPERF_EVENT_CUSTOM_MAX || ((flags & LIBPERF_INIT_LAZY) && (flags & (LIBPERF_INIT_GROUP | LIBPERF_INIT_ENABLE_ON_EXEC)))) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid set of %lu events supplied", __func__, count);
+		errno = EINVAL;
+		return NULL;
+	}
+	if ((flags & LIBPERF_INIT_CGROUP) && (id < 0 || cpu < 0)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): cgroups can only be tracked on a concrete CPU", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	libperf_tracker *pd = libperf_alloc(id, cpu);
+	if (pd == NULL) {
+		return NULL;
+	}
+	if (flags & LIBPERF_INIT_CGROUP) {
+		pd->open_flags |= PERF_FLAG_PID_CGROUP;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		const enum libperf_event counter = LIBPERF_EVENT_CUSTOM_N(i);
+
+		pd->attrs[counter] = attrs[i]; // caller decides what's tracked and how, bar what libperf relies upon
+		pd->attrs[counter].size = sizeof(struct perf_event_attr);
+		pd->attrs[counter].disabled = 1;
+		pd->attrs[counter].read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		if (flags & LIBPERF_INIT_NO_INHERIT) {
+			pd->attrs[counter].inherit = 0;
+		}
+		if (flags & LIBPERF_INIT_ENABLE_ON_EXEC) {
+			pd->attrs[counter].enable_on_exec = 1;
+		}
+
+		if (flags & LIBPERF_INIT_GROUP) {
+			if (!libperf_open_member(pd, counter, __func__)) {
+				libperf_close_all(pd);
 				return NULL;
-			} else { // for others, we print a warning and that's it
-				syslog(LOG_WARNING, "libperf (in %s): Event #%lu unsupported but continuing; refer to documentation & manual pages", __func__, i);
 			}
+		} else if (flags & LIBPERF_INIT_LAZY) {
+			pd->pending |= LIBPERF_EVENT_MASK(counter);
+			continue;
+		} else if (libperf_open_counter(pd, (size_t)counter) == LIBPERF_EXIT_SYSTEM_ERROR) {
+			libperf_diag(LOG_ERR, "libperf (in %s): aborting initialisation", __func__);
+			libperf_close_all(pd);
+			return NULL;
+		}
+
+		if (pd->fds[counter] >= 0 && (flags & LIBPERF_INIT_ENABLE_ON_EXEC)) {
+			pd->enabled |= LIBPERF_EVENT_MASK(counter); // kernel enables it come exec, and reads before then simply yield 0
 		}
 	}
 
 	pd->wall_start = rdclock();
 
-	syslog(LOG_INFO, "libperf (in %s): library initialised", __func__);
+	libperf_diag(LOG_INFO, "libperf (in %s): library initialised with %lu caller-defined events", __func__, count);
 	return pd;
 }
 
-enum libperf_exit libperf_toggle_counter(libperf_tracker *const pd, const enum libperf_event counter, const enum libperf_event_toggle toggle_type, ...)
+/**
+ * @brief libperf_open_pending - opens a lazily selected counter, if it hasn't been yet
+ * @pre pd->lock held
+ * @param libperf_tracker *const pd - tracker
+ * @param const size_t counter - counter to open
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static enum libperf_exit libperf_open_pending(libperf_tracker *const pd, const size_t counter)
 {
-	if (pd == NULL) {
-		syslog(LOG_ERR, "libperf (in %s): invalid handle", __func__);
-		return LIBPERF_EXIT_HANDLE_INVALID;
+	if ((pd->pending & LIBPERF_EVENT_MASK(counter)) == 0) {
+		return LIBPERF_EXIT_SUCCESS;
 	}
 
-	if (counter < 0 || counter > LIBPERF_MAX_COUNTERS) {
-		syslog(LOG_ERR, "libperf (in %s): invalid perf event counter '%d' supplied\n", __func__, counter);
-		return LIBPERF_EXIT_COUNTER_INVALID;
+	const enum libperf_exit rt = libperf_open_counter(pd, counter);
+	__atomic_and_fetch(&pd->pending, ~LIBPERF_EVENT_MASK(counter), __ATOMIC_RELEASE); // release pairs with readers' acquire, so they only see the counter once its fd (& page) are in place
+	return rt;
+}
+
+/**
+ * @brief libperf_toggle_locked - manipulates a counter
+ * @pre pd->lock held
+ * @param libperf_tracker *const pd - tracker
+ * @param const enum libperf_event counter - (valid) counter type
+ * @param const enum libperf_event_toggle toggle_type - how to manipulate event
+ * @param va_list args - argument of toggle_type, if any
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static enum libperf_exit libperf_toggle_locked(libperf_tracker *const pd, const enum libperf_event counter, const enum libperf_event_toggle toggle_type, va_list args)
+{
+	const enum libperf_exit rt = libperf_open_pending(pd, (size_t)counter); // selected counter, opened on first use
+	if (rt != LIBPERF_EXIT_SUCCESS) {
+		return rt;
 	}
 
-	if (pd->fds[counter] < 0) { // if a specific counter isn't even active (due to failing in libperf_init)
-		syslog(LOG_ERR, "libperf (in %s): counter '%d' not initialised", __func__, counter);
+	if (pd->fds[counter] < 0) { // if a specific counter isn't even active (due to failing in libperf_init, or not being selected)
+		libperf_diag(LOG_ERR, "libperf (in %s): counter '%d' not initialised", __func__, counter);
 		return LIBPERF_EXIT_COUNTER_UNINITIALISABLE;
 	}
 
-	va_list args;
-	va_start(args, toggle_type);
 	switch (toggle_type) {
 		case LIBPERF_EVENT_TOGGLE_ON:;
 			if (ioctl(pd->fds[counter], PERF_EVENT_IOC_ENABLE) != 0) { // 0 is good, non-zero is bad 
-				syslog(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
+				libperf_diag(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
 				return LIBPERF_EXIT_SYSTEM_ERROR;
 			}
-			pd->attrs[counter].disabled = 0;
+			__atomic_or_fetch(&pd->enabled, LIBPERF_EVENT_MASK(counter), __ATOMIC_RELEASE);
 			break;
 		case LIBPERF_EVENT_TOGGLE_OFF:;
 			if (ioctl(pd->fds[counter], PERF_EVENT_IOC_DISABLE) != 0) {
-				syslog(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
+				libperf_diag(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
 				return LIBPERF_EXIT_SYSTEM_ERROR;
 			}
-			pd->attrs[counter].disabled = 1;
+			__atomic_and_fetch(&pd->enabled, ~LIBPERF_EVENT_MASK(counter), __ATOMIC_RELEASE);
 			break;
 		case LIBPERF_EVENT_TOGGLE_RESET:;
 			if (ioctl(pd->fds[counter], PERF_EVENT_IOC_RESET) != 0) {
-				syslog(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
+				libperf_diag(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
 				return LIBPERF_EXIT_SYSTEM_ERROR;
 			}
 			break;
 		case LIBPERF_EVENT_TOGGLE_OVERFLOW_REFRESH:;
 			const uint64_t overflows = va_arg(args, uint64_t);
 			if (ioctl(pd->fds[counter], PERF_EVENT_IOC_REFRESH, overflows) != 0) {
-				syslog(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
+				libperf_diag(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
 				return LIBPERF_EXIT_SYSTEM_ERROR;
 			}
 			break;
 		case LIBPERF_EVENT_TOGGLE_OVERFLOW_PERIOD:;
 			uint64_t *const period = va_arg(args, uint64_t *);
 			if (ioctl(pd->fds[counter], PERF_EVENT_IOC_PERIOD, period) != 0) {
-				syslog(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
+				libperf_diag(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
 				return LIBPERF_EXIT_SYSTEM_ERROR;
 			}
 			break;
 		case LIBPERF_EVENT_TOGGLE_OUTPUT:;
 			const uint32_t pause = va_arg(args, uint32_t);
 			if (ioctl(pd->fds[counter], PERF_EVENT_IOC_PAUSE_OUTPUT, pause) != 0) {
-				syslog(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
+				libperf_diag(LOG_ERR, "libperf (in %s): unable to configure counter '%d'", __func__, counter);
 				return LIBPERF_EXIT_SYSTEM_ERROR;
 			}
 			break;
 		default:;
-			syslog(LOG_ERR, "libperf (in %s): unsupported configuration supplied", __func__);
+			libperf_diag(LOG_ERR, "libperf (in %s): unsupported configuration supplied", __func__);
 			return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
 	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): counter '%d' manipulated successfully", __func__, counter);
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_toggle_counter(libperf_tracker *const pd, const enum libperf_event counter, const enum libperf_event_toggle toggle_type, ...)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (!libperf_is_counter(counter)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid perf event counter '%d' supplied\n", __func__, counter);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	va_list args;
+	va_start(args, toggle_type);
+	pthread_mutex_lock(&pd->lock);
+	const enum libperf_exit rt = libperf_toggle_locked(pd, counter, toggle_type, args);
+	pthread_mutex_unlock(&pd->lock);
 	va_end(args);
 
-	syslog(LOG_INFO, "libperf (in %s): counter '%d' manipulated successfully", __func__, counter);
+	return rt;
+}
+
+/**
+ * @brief libperf_toggle_counters_locked - enables, disables or resets a set of counters at once
+ * @pre pd->lock held
+ * @param libperf_tracker *const pd - tracker
+ * @param const uint64_t events - (valid) mask of counters
+ * @param const enum libperf_event_toggle toggle_type - how to manipulate them
+ * @param const unsigned long request - ioctl request of toggle_type
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static enum libperf_exit libperf_toggle_counters_locked(libperf_tracker *const pd, const uint64_t events, const enum libperf_event_toggle toggle_type, const unsigned long request)
+{
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) { // open any lazy counters first, so all or none are toggled
+		if ((events & LIBPERF_EVENT_MASK(i)) == 0) {
+			continue;
+		}
+
+		const enum libperf_exit rt = libperf_open_pending(pd, i);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+
+		if (pd->fds[i] < 0) {
+			libperf_diag(LOG_ERR, "libperf (in %s): counter '%lu' not initialised", __func__, i);
+			return LIBPERF_EXIT_COUNTER_UNINITIALISABLE;
+		}
+	}
+
+	uint64_t members = 0;
+	for (size_t i = 0; i < pd->members_count; ++i) {
+		members |= LIBPERF_EVENT_MASK(pd->members[i]);
+	}
+
+	uint64_t remaining = events;
+	if (members != 0 && (events & members) == members) { // whole group, so leader acts for every member in one go
+		if (ioctl(pd->group, request, PERF_IOC_FLAG_GROUP) != 0) {
+			libperf_diag(LOG_ERR, "libperf (in %s): unable to configure group", __func__);
+			return LIBPERF_EXIT_SYSTEM_ERROR;
+		}
+		remaining &= ~members;
+	}
+
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) {
+		if ((remaining & LIBPERF_EVENT_MASK(i)) != 0 && ioctl(pd->fds[i], request) != 0) {
+			libperf_diag(LOG_ERR, "libperf (in %s): unable to configure counter '%lu'", __func__, i);
+			return LIBPERF_EXIT_SYSTEM_ERROR;
+		}
+	}
+
+	if (toggle_type == LIBPERF_EVENT_TOGGLE_ON) { // readers see the whole set change at once
+		__atomic_or_fetch(&pd->enabled, events, __ATOMIC_RELEASE);
+	} else if (toggle_type == LIBPERF_EVENT_TOGGLE_OFF) {
+		__atomic_and_fetch(&pd->enabled, ~events, __ATOMIC_RELEASE);
+	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): counters '%#lx' manipulated successfully", __func__, events);
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_toggle_counters(libperf_tracker *const pd, const uint64_t events, const enum libperf_event_toggle toggle_type)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if ((events & ~(LIBPERF_EVENT_MASK_ALL | LIBPERF_EVENT_MASK_CUSTOM)) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid perf event counters '%#lx' supplied", __func__, events);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	unsigned long request;
+	switch (toggle_type) {
+		case LIBPERF_EVENT_TOGGLE_ON:;
+			request = PERF_EVENT_IOC_ENABLE;
+			break;
+		case LIBPERF_EVENT_TOGGLE_OFF:;
+			request = PERF_EVENT_IOC_DISABLE;
+			break;
+		case LIBPERF_EVENT_TOGGLE_RESET:;
+			request = PERF_EVENT_IOC_RESET;
+			break;
+		default:;
+			libperf_diag(LOG_ERR, "libperf (in %s): unsupported configuration supplied", __func__);
+			return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+
+	pthread_mutex_lock(&pd->lock);
+	const enum libperf_exit rt = libperf_toggle_counters_locked(pd, events, toggle_type, request);
+	pthread_mutex_unlock(&pd->lock);
+
+	return rt;
+}
+
+enum libperf_exit libperf_toggle_process(const enum libperf_event_toggle toggle_type)
+{
+	int option;
+	switch (toggle_type) {
+		case LIBPERF_EVENT_TOGGLE_ON:;
+			option = PR_TASK_PERF_EVENTS_ENABLE;
+			break;
+		case LIBPERF_EVENT_TOGGLE_OFF:;
+			option = PR_TASK_PERF_EVENTS_DISABLE;
+			break;
+		default:;
+			libperf_diag(LOG_ERR, "libperf (in %s): unsupported configuration supplied", __func__);
+			return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+
+	if (prctl(option, 0, 0, 0, 0) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to configure process' counters", __func__);
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+/**
+ * @brief libperf_scale - estimates what a counter would have been, had it been on the PMU the whole time it was enabled
+ * @param struct libperf_counter_value *const value - value whose raw count & times are filled in, to fill the scaled estimate of
+ */
+static inline void libperf_scale(struct libperf_counter_value *const value)
+{
+	if (value->time_running == 0) { // never made it onto the PMU, so there's nothing to extrapolate from
+		value->scaled = 0;
+	} else if (value->time_running >= value->time_enabled) { // wasn't multiplexed
+		value->scaled = value->raw;
+	} else {
+		value->scaled = (uint64_t)((double)value->raw * ((double)value->time_enabled / (double)value->time_running));
+	}
+}
+
+/**
+ * @brief libperf_fetch_group - reads every member of the group with a single syscall
+ * @param libperf_tracker *const pd - grouped tracker
+ * @param struct libperf_counter_value *const values - array indexed by enum libperf_event to write member values out to
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static enum libperf_exit libperf_fetch_group(libperf_tracker *const pd, struct libperf_counter_value *const values)
+{
+	/* layout with PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_*: { u64 nr; u64 time_enabled; u64 time_running; { u64 value; u64 id; } cntr[nr]; } */
+	uint64_t buffer[3 + (2 * LIBPERF_EVENT_SLOTS)];
+	const size_t expected = (3 + (2 * pd->members_count)) * sizeof(uint64_t);
+
+	if (read(pd->group, buffer, sizeof(buffer)) != (ssize_t)expected) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to read group", __func__);
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	for (size_t i = 0; i < pd->members_count; ++i) {
+		const uint64_t read_id = buffer[4 + (2 * i)];
+		enum libperf_event member = pd->members[i]; // kernel reports leader then siblings, ie declaration order
+		if (pd->ids[member] != read_id) { // but don't rely on it
+			for (size_t j = 0; j < pd->members_count; ++j) {
+				if (pd->ids[pd->members[j]] == read_id) {
+					member = pd->members[j];
+					break;
+				}
+			}
+		}
+		values[member].raw = buffer[3 + (2 * i)];
+		values[member].time_enabled = buffer[1]; // members are scheduled together, hence share times
+		values[member].time_running = buffer[2];
+		libperf_scale(&values[member]);
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+/**
+ * @brief libperf_fetch_counter - reads a single (valid, opened) counter by whichever means is cheapest
+ * @param libperf_tracker *const pd - tracker
+ * @param const enum libperf_event counter - counter to read
+ * @param struct libperf_counter_value *const value - value to write out to
+ * @param const bool timed - whether enabled/running times (and hence the scaled estimate) are wanted, which costs a little more on the rdpmc path
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static inline enum libperf_exit libperf_fetch_counter(libperf_tracker *const pd, const enum libperf_event counter, struct libperf_counter_value *const value, const bool timed)
+{
+	if (pd->pages[counter] != NULL && libperf_read_page(pd->pages[counter], value, timed)) { // fast path: no syscall at all
+		if (timed) {
+			libperf_scale(value);
+		}
+		return LIBPERF_EXIT_SUCCESS;
+	}
+
+	if (pd->attrs[counter].read_format & PERF_FORMAT_GROUP) { // group members can only be read as a whole
+		struct libperf_counter_value by_event[LIBPERF_EVENT_SLOTS];
+		const enum libperf_exit rt = libperf_fetch_group(pd, by_event);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+		*value = by_event[counter];
+		return LIBPERF_EXIT_SUCCESS;
+	}
+
+	/* layout with PERF_FORMAT_TOTAL_TIME_*: { u64 value; u64 time_enabled; u64 time_running; } */
+	uint64_t buffer[3];
+	if (read(pd->fds[counter], buffer, sizeof(buffer)) != sizeof(buffer)) { // if there was an error reading the counter
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to read event for counter '%d'", __func__, counter);
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	value->raw = buffer[0];
+	value->time_enabled = buffer[1];
+	value->time_running = buffer[2];
+	libperf_scale(value);
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+/**
+ * @brief libperf_check_counter - checks a perf counter (ie not a special library counter) can be read
+ * @param const libperf_tracker *const pd - tracker
+ * @param const enum libperf_event counter - counter type
+ * @param const char *const caller - name of API function, for logging
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static inline enum libperf_exit libperf_check_counter(const libperf_tracker *const pd, const enum libperf_event counter, const char *const caller)
+{
+	/* disabled (or pending) counters are an expected state callers branch on, not a fault, so aren't diagnosed */
+	if (__atomic_load_n(&pd->pending, __ATOMIC_ACQUIRE) & LIBPERF_EVENT_MASK(counter)) { // not opened yet as never toggled on, so as good as disabled; acquire pairs with libperf_open_pending()
+		return LIBPERF_EXIT_COUNTER_DISABLED;
+	}
+
+	if (pd->fds[counter] < 0) { // ie we weren't able to initialise it in the first place
+		libperf_diag(LOG_ERR, "libperf (in %s): counter '%d' not initialised", caller, counter);
+		return LIBPERF_EXIT_COUNTER_UNINITIALISABLE;
+	}
+
+	if ((__atomic_load_n(&pd->enabled, __ATOMIC_ACQUIRE) & LIBPERF_EVENT_MASK(counter)) == 0) {
+		return LIBPERF_EXIT_COUNTER_DISABLED;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_read_group(libperf_tracker *const pd, uint64_t *const values)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (pd->group < 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): tracker was not initialised as a group", __func__);
+		return LIBPERF_EXIT_GROUP_INVALID;
+	}
+
+	if (pd->read_mode == LIBPERF_READ_MODE_RDPMC) { // members are read back to back from userspace, only resorting to a syscall if any of them can't be
+		size_t i = 0;
+		for (; i < pd->members_count; ++i) {
+			struct libperf_counter_value value;
+			const enum libperf_event member = pd->members[i];
+			if (pd->pages[member] == NULL || !libperf_read_page(pd->pages[member], &value, false)) {
+				break;
+			}
+			values[i] = value.raw;
+		}
+
+		if (i == pd->members_count) {
+			return LIBPERF_EXIT_SUCCESS;
+		}
+	}
+
+	struct libperf_counter_value by_event[LIBPERF_EVENT_SLOTS];
+	const enum libperf_exit rt = libperf_fetch_group(pd, by_event);
+	if (rt != LIBPERF_EXIT_SUCCESS) {
+		return rt;
+	}
+
+	for (size_t i = 0; i < pd->members_count; ++i) {
+		values[i] = by_event[pd->members[i]].raw;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_read_mode libperf_get_read_mode(const libperf_tracker *const pd)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_READ_MODE_SYSCALL;
+	}
+
+	return pd->read_mode;
+}
+
+size_t libperf_group_size(const libperf_tracker *const pd)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return pd->members_count;
+}
+
+enum libperf_exit libperf_read_group_scaled(libperf_tracker *const pd, struct libperf_counter_value *const values)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (pd->group < 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): tracker was not initialised as a group", __func__);
+		return LIBPERF_EXIT_GROUP_INVALID;
+	}
+
+	struct libperf_counter_value by_event[LIBPERF_EVENT_SLOTS];
+	const enum libperf_exit rt = libperf_fetch_group(pd, by_event);
+	if (rt != LIBPERF_EXIT_SUCCESS) {
+		return rt;
+	}
+
+	for (size_t i = 0; i < pd->members_count; ++i) {
+		values[i] = by_event[pd->members[i]];
+	}
+
 	return LIBPERF_EXIT_SUCCESS;
 }
 
 enum libperf_exit libperf_read_counter(libperf_tracker *const pd, const enum libperf_event counter, uint64_t *const value)
 {
 	if (pd == NULL) {
-		syslog(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
 		return LIBPERF_EXIT_HANDLE_INVALID;
 	}
 
-	if (counter < 0 || counter > LIBPERF_MAX_COUNTERS + LIBPERF_ADDITIONAL_COUNTERS) {
-		syslog(LOG_ERR, "libperf (in %s): invalid perf event or special library counter '%d' supplied", __func__, counter);
+	if (!libperf_is_counter(counter) && counter != LIBPERF_LIB_SW_WALL_TIME) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid perf event or special library counter '%d' supplied", __func__, counter);
 		return LIBPERF_EXIT_COUNTER_INVALID;
 	}
 
@@ -298,45 +1068,289 @@ enum libperf_exit libperf_read_counter(libperf_tracker *const pd, const enum lib
 		*value = (uint64_t)(rdclock() - pd->wall_start);
 	}
 	else { // all other instructions
-		if (pd->fds[counter] < 0) { // ie we weren't able to initialise it in the first place
-			syslog(LOG_ERR, "libperf (in %s): counter '%d' not initialised", __func__, counter);
-			return LIBPERF_EXIT_COUNTER_UNINITIALISABLE;
+		enum libperf_exit rt = libperf_check_counter(pd, counter, __func__);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
 		}
 
-		if (pd->attrs[counter].disabled == 1) {
-			syslog(LOG_ERR, "libperf (in %s): counter '%d' disabled", __func__, counter);
-			return LIBPERF_EXIT_COUNTER_DISABLED;
+		struct libperf_counter_value read_value;
+		rt = libperf_fetch_counter(pd, counter, &read_value, false);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
 		}
+		*value = read_value.raw;
+	}
 
-		if (read(pd->fds[counter], value, sizeof(uint64_t)) != sizeof(uint64_t)) { // if there was an error reading the counter
-			syslog(LOG_ERR, "libperf (in %s): unable to read event for counter '%d'", __func__, counter);
-			return LIBPERF_EXIT_SYSTEM_ERROR;
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_read_counter_scaled(libperf_tracker *const pd, const enum libperf_event counter, struct libperf_counter_value *const value)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (!libperf_is_counter(counter)) { // special library counters aren't multiplexed, so don't apply
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid perf event counter '%d' supplied", __func__, counter);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	const enum libperf_exit rt = libperf_check_counter(pd, counter, __func__);
+	if (rt != LIBPERF_EXIT_SUCCESS) {
+		return rt;
+	}
+
+	return libperf_fetch_counter(pd, counter, value, true);
+}
+
+enum libperf_exit libperf_read_enabled(libperf_tracker *const pd, uint64_t *const events, uint64_t *const values)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	struct libperf_counter_value group_values[LIBPERF_EVENT_SLOTS];
+	if (pd->group >= 0) { // as with libperf_log, a single consistent snapshot of the group
+		const enum libperf_exit rt = libperf_fetch_group(pd, group_values);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+	}
+
+	const uint64_t enabled = __atomic_load_n(&pd->enabled, __ATOMIC_ACQUIRE); // counters only become enabled once opened, so their fds are in place
+
+	*events = 0;
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) {
+		if ((enabled & LIBPERF_EVENT_MASK(i)) == 0) { // never opened (or still pending), or switched off
+			continue;
+		}
+
+		if (pd->attrs[i].read_format & PERF_FORMAT_GROUP) {
+			values[i] = group_values[i].raw;
+		} else {
+			struct libperf_counter_value value;
+			const enum libperf_exit rt = libperf_fetch_counter(pd, (enum libperf_event)i, &value, false);
+			if (rt != LIBPERF_EXIT_SUCCESS) {
+				return rt;
+			}
+			values[i] = value.raw;
 		}
+		*events |= LIBPERF_EVENT_MASK(i);
 	}
 
 	return LIBPERF_EXIT_SUCCESS;
 }
 
+enum libperf_exit libperf_snapshot_take(libperf_tracker *const pd, struct libperf_snapshot *const snapshot)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	snapshot->mask = 0;
+	snapshot->count = 0;
+
+	if (pd->group >= 0) { // one syscall for the lot, in declaration order
+		struct libperf_counter_value by_event[LIBPERF_EVENT_SLOTS];
+		const enum libperf_exit rt = libperf_fetch_group(pd, by_event);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+
+		for (size_t i = 0; i < pd->members_count; ++i) {
+			const enum libperf_event member = pd->members[i];
+			snapshot->values[i] = by_event[member].raw;
+			snapshot->time_enabled[i] = by_event[member].time_enabled;
+			snapshot->time_running[i] = by_event[member].time_running;
+			snapshot->events[i] = member;
+			snapshot->mask |= LIBPERF_EVENT_MASK(member);
+		}
+		snapshot->count = pd->members_count;
+
+		return LIBPERF_EXIT_SUCCESS;
+	}
+
+	const uint64_t pending = __atomic_load_n(&pd->pending, __ATOMIC_ACQUIRE); // fds of counters no longer pending are in place
+
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) {
+		const uint64_t selected = LIBPERF_EVENT_MASK(i);
+		if ((pending & selected) == 0 && pd->fds[i] < 0) { // never asked for, or unsupported
+			continue;
+		}
+
+		struct libperf_counter_value value = { 0, 0, 0, 0 };
+		if ((pending & selected) == 0) {
+			const enum libperf_exit rt = libperf_fetch_counter(pd, (enum libperf_event)i, &value, true);
+			if (rt != LIBPERF_EXIT_SUCCESS) {
+				return rt;
+			}
+		}
+
+		const size_t entry = snapshot->count++;
+		snapshot->values[entry] = value.raw;
+		snapshot->time_enabled[entry] = value.time_enabled;
+		snapshot->time_running[entry] = value.time_running;
+		snapshot->events[entry] = (enum libperf_event)i;
+		snapshot->mask |= selected;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_snapshot_delta(const struct libperf_snapshot *const begin, const struct libperf_snapshot *const end, struct libperf_snapshot *const delta)
+{
+	if (begin->mask != end->mask || begin->count != end->count) {
+		libperf_diag(LOG_ERR, "libperf (in %s): snapshots cover different events", __func__);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	const size_t count = end->count;
+	for (size_t i = 0; i < count; ++i) {
+		delta->values[i] = end->values[i] - begin->values[i];
+	}
+	for (size_t i = 0; i < count; ++i) {
+		delta->time_enabled[i] = end->time_enabled[i] - begin->time_enabled[i];
+	}
+	for (size_t i = 0; i < count; ++i) {
+		delta->time_running[i] = end->time_running[i] - begin->time_running[i];
+	}
+
+	if (delta != end) {
+		memcpy(delta->events, end->events, count * sizeof(enum libperf_event));
+		delta->mask = end->mask;
+		delta->count = count;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_snapshot_accumulate(struct libperf_snapshot *const total, const struct libperf_snapshot *const delta)
+{
+	if (total->count == 0) { // nothing accumulated yet, so take on the layout of what's being added
+		memcpy(total->events, delta->events, delta->count * sizeof(enum libperf_event));
+		memset(total->values, 0, delta->count * sizeof(uint64_t));
+		memset(total->time_enabled, 0, delta->count * sizeof(uint64_t));
+		memset(total->time_running, 0, delta->count * sizeof(uint64_t));
+		total->mask = delta->mask;
+		total->count = delta->count;
+	} else if (total->mask != delta->mask || total->count != delta->count) {
+		libperf_diag(LOG_ERR, "libperf (in %s): snapshots cover different events", __func__);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	const size_t count = total->count;
+	for (size_t i = 0; i < count; ++i) {
+		total->values[i] += delta->values[i];
+	}
+	for (size_t i = 0; i < count; ++i) {
+		total->time_enabled[i] += delta->time_enabled[i];
+	}
+	for (size_t i = 0; i < count; ++i) {
+		total->time_running[i] += delta->time_running[i];
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+void libperf_snapshot_scale(const struct libperf_snapshot *const snapshot, uint64_t *const scaled)
+{
+	for (size_t i = 0; i < snapshot->count; ++i) {
+		struct libperf_counter_value value = { snapshot->values[i], snapshot->time_enabled[i], snapshot->time_running[i], 0 };
+		libperf_scale(&value);
+		scaled[i] = value.scaled;
+	}
+}
+
+int libperf_snapshot_index(const struct libperf_snapshot *const snapshot, const enum libperf_event event)
+{
+	if (event < 0 || event >= LIBPERF_EVENT_SLOTS || (snapshot->mask & LIBPERF_EVENT_MASK(event)) == 0) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < snapshot->count; ++i) {
+		if (snapshot->events[i] == event) {
+			return (int)i;
+		}
+	}
+
+	return -1;
+}
+
+enum libperf_exit libperf_set_read_mode(libperf_tracker *const pd, const enum libperf_read_mode mode)
+{
+	if (pd == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (mode != LIBPERF_READ_MODE_SYSCALL && mode != LIBPERF_READ_MODE_RDPMC) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unsupported read mode supplied", __func__);
+		return LIBPERF_EXIT_READ_MODE_UNSUPPORTED;
+	}
+
+	if (mode == LIBPERF_READ_MODE_RDPMC && (pd->cpu != -1 || (pd->id != 0 && pd->id != (pid_t)syscall(SYS_gettid)))) { // rdpmc reads the PMU of whichever CPU we're on, so only self-monitoring makes sense
+		libperf_diag(LOG_ERR, "libperf (in %s): rdpmc reads require tracking the calling thread on any CPU", __func__);
+		return LIBPERF_EXIT_READ_MODE_UNSUPPORTED;
+	}
+
+	pthread_mutex_lock(&pd->lock); // lazy counters opened by toggles are set up to match
+	if (mode == LIBPERF_READ_MODE_SYSCALL) {
+		libperf_unmap_pages(pd);
+	} else {
+		for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) {
+			if (pd->fds[i] >= 0 && pd->pages[i] == NULL) {
+				libperf_map_page(pd, i);
+			}
+		}
+	}
+	pd->read_mode = mode;
+	pthread_mutex_unlock(&pd->lock);
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
 enum libperf_exit libperf_log(libperf_tracker *const pd, FILE *const stream, const size_t tag)
 {
 	if (pd == NULL) {
-		syslog(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
 		return LIBPERF_EXIT_HANDLE_INVALID;
 	}
 
-	for (size_t i = 0; i < LIBPERF_MAX_COUNTERS; ++i) {
-		uint64_t value;
-		const enum libperf_exit rt = libperf_read_counter(pd, (enum libperf_event)i, &value);
-		if (rt == LIBPERF_EXIT_COUNTER_DISABLED || rt == LIBPERF_EXIT_COUNTER_UNINITIALISABLE) {
-			continue; // these errors are counter-specific and acceptable, move onto next one
-		} else if(rt != LIBPERF_EXIT_SUCCESS) {
-			return rt; // exit+return error which are not recoverable
+	struct libperf_counter_value group_values[LIBPERF_EVENT_SLOTS];
+	if (pd->group >= 0) { // grouped trackers get a single, consistent snapshot rather than one read per counter
+		const enum libperf_exit rt = libperf_fetch_group(pd, group_values);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+	}
+
+	const uint64_t enabled = __atomic_load_n(&pd->enabled, __ATOMIC_ACQUIRE); // counters only become enabled once opened, so their fds are in place
+
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) {
+		if (!libperf_is_counter((enum libperf_event)i) || (enabled & LIBPERF_EVENT_MASK(i)) == 0) { // only counters opened & toggled on are worth logging, and checking here spares a read of each of the rest
+			continue;
+		}
+
+		struct libperf_counter_value value;
+		if (pd->attrs[i].read_format & PERF_FORMAT_GROUP) {
+			value = group_values[i];
+		} else {
+			const enum libperf_exit rt = libperf_read_counter_scaled(pd, (enum libperf_event)i, &value);
+			if (rt == LIBPERF_EXIT_COUNTER_DISABLED || rt == LIBPERF_EXIT_COUNTER_UNINITIALISABLE) {
+				continue; // these errors are counter-specific and acceptable, move onto next one
+			} else if(rt != LIBPERF_EXIT_SUCCESS) {
+				return rt; // exit+return error which are not recoverable
+			}
 		}
 		// else, if success
-		fprintf(stream, "%s[%lu]: %lu\n", libperf_event_name[i], tag, value); // log raw value
+		const double running = value.time_enabled == 0 ? 100.0 : (100.0 * (double)value.time_running) / (double)value.time_enabled;
+		fprintf(stream, "%s[%lu]: %lu (%.2f%% running)\n", libperf_event_names[i], tag, value.raw, running); // log raw value, with how much of it was measured rather than multiplexed out
 	}
 
-	fprintf(stream, "%s[%lu]: %14.9f\n", libperf_event_name[LIBPERF_LIB_SW_WALL_TIME], tag, rdclock() - pd->wall_start); // log raw value
+	fprintf(stream, "%s[%lu]: %14.9f\n", libperf_event_names[LIBPERF_LIB_SW_WALL_TIME], tag, rdclock() - pd->wall_start); // log raw value
 
 	return LIBPERF_EXIT_SUCCESS;
 }
@@ -344,18 +1358,11 @@ enum libperf_exit libperf_log(libperf_tracker *const pd, FILE *const stream, con
 void libperf_fini(libperf_tracker *const pd)
 {
 	if (pd == NULL) {
-		syslog(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
 		return;
 	}
 
-	for (size_t i = 0; i <  LIBPERF_MAX_COUNTERS; ++i) {
-		if (pd->fds[i] >= 0) {
-			close(pd->fds[i]);
-		}
-	}
-
-	free(pd->attrs);
-	free(pd);
+	libperf_close_all(pd);
 
-	syslog(LOG_NOTICE, "libperf (in %s): library shut down", __func__);
+	libperf_diag(LOG_NOTICE, "libperf (in %s): library shut down", __func__);
 }
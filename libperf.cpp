@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <cerrno>
 #include <cstdarg>
+#include <initializer_list>
 
 #include "libperf.h"
 
@@ -42,6 +43,12 @@ std::string libperf::Error::message(int condition) const
 		case LIBPERF_EXIT_COUNTER_DISABLED:
 			message = "Counter currently disabled" ;
 			break ;
+		case LIBPERF_EXIT_GROUP_INVALID:
+			message = "Tracker is not a group" ;
+			break ;
+		case LIBPERF_EXIT_READ_MODE_UNSUPPORTED:
+			message = "Read mode not supported for tracker" ;
+			break ;
 		default:
 			message = "Unknown error" ;
 	}
@@ -58,6 +65,33 @@ libperf::Tracker::Tracker(const pid_t id, const int cpu) noexcept(false)
 	}
 }
 
+libperf::Tracker::Tracker(const pid_t id, const int cpu, const std::uint64_t events, const unsigned int flags) noexcept(false)
+{
+	this->_tracker = libperf_init_selective(id, cpu, events, flags) ;
+	if(this->_tracker == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Tracker::Tracker(const pid_t id, const int cpu, std::initializer_list<libperf_event> group) noexcept(false)
+{
+	this->_tracker = libperf_init_group(id, cpu, group.begin(), group.size()) ;
+	if(this->_tracker == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Tracker::Tracker(const pid_t id, const int cpu, const perf_event_attr *const attrs, const std::size_t count, const unsigned int flags) noexcept(false)
+{
+	this->_tracker = libperf_init_explicit(id, cpu, attrs, count, flags) ;
+	if(this->_tracker == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
 libperf::Tracker::Tracker(libperf::Tracker&& tracker) noexcept
 {
 	this->_tracker = tracker._tracker ;
@@ -66,8 +100,15 @@ libperf::Tracker::Tracker(libperf::Tracker&& tracker) noexcept
 
 libperf::Tracker& libperf::Tracker::operator=(libperf::Tracker&& tracker) noexcept
 {
-	this->_tracker = tracker._tracker ;
-	tracker._tracker = nullptr ;
+	if(this != &tracker)
+	{
+		if(this->_tracker != nullptr)
+		{
+			libperf_fini(this->_tracker) ;
+		}
+		this->_tracker = tracker._tracker ;
+		tracker._tracker = nullptr ;
+	}
 
 	return *this ;
 }
@@ -91,6 +132,69 @@ std::uint64_t libperf::Tracker::read_counter(const libperf_event counter) const
 	return value ;
 }
 
+void libperf::Tracker::read_group(std::uint64_t *const values) const noexcept(false)
+{
+	const auto err = libperf_read_group(this->_tracker, values) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+void libperf::Tracker::toggle_counters(const std::uint64_t events, const libperf_event_toggle toggle_type) noexcept(false)
+{
+	const auto err = libperf_toggle_counters(this->_tracker, events, toggle_type) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+void libperf::Tracker::toggle_process(const libperf_event_toggle toggle_type) noexcept(false)
+{
+	const auto err = libperf_toggle_process(toggle_type) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+std::uint64_t libperf::Tracker::read_enabled(std::uint64_t *const values) const noexcept(false)
+{
+	std::uint64_t events = 0 ;
+	const auto err = libperf_read_enabled(this->_tracker, &events, values) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+
+	return events ;
+}
+
 void libperf::Tracker::toggle_counter(const libperf_event counter, const libperf_event_toggle toggle_type, ...) noexcept(false)
 {
 	libperf_exit err ;
@@ -134,6 +238,70 @@ void libperf::Tracker::toggle_counter(const libperf_event counter, const libperf
 	}
 }
 
+libperf_counter_value libperf::Tracker::read_counter_scaled(const libperf_event counter) const noexcept(false)
+{
+	libperf_counter_value value ;
+
+	const auto err = libperf_read_counter_scaled(this->_tracker, counter, &value) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+
+	return value ;
+}
+
+void libperf::Tracker::read_group_scaled(libperf_counter_value *const values) const noexcept(false)
+{
+	const auto err = libperf_read_group_scaled(this->_tracker, values) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+void libperf::Tracker::set_read_mode(const libperf_read_mode mode) noexcept(false)
+{
+	const auto err = libperf_set_read_mode(this->_tracker, mode) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+libperf_read_mode libperf::Tracker::read_mode() const noexcept
+{
+	return libperf_get_read_mode(this->_tracker) ;
+}
+
+std::size_t libperf::Tracker::group_size() const noexcept
+{
+	return libperf_group_size(this->_tracker) ;
+}
+
+libperf_tracker* libperf::Tracker::handle() const noexcept
+{
+	return this->_tracker ;
+}
+
 void libperf::Tracker::log(std::FILE *const stream, const std::size_t tag) const noexcept(false)
 {
 	const auto err = libperf_log(this->_tracker, stream, tag) ;
@@ -151,5 +319,105 @@ void libperf::Tracker::log(std::FILE *const stream, const std::size_t tag) const
 
 libperf::Tracker::~Tracker() noexcept
 {
-	libperf_fini(this->_tracker) ;
+	if(this->_tracker != nullptr)
+	{
+		libperf_fini(this->_tracker) ;
+	}
+}
+
+libperf::Snapshot::Snapshot() noexcept
+{
+	this->_snapshot.mask = 0 ;
+	this->_snapshot.count = 0 ;
+}
+
+libperf::Snapshot::Snapshot(const libperf::Tracker& tracker) noexcept(false)
+{
+	const auto err = libperf_snapshot_take(tracker.handle(), &this->_snapshot) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+bool libperf::Snapshot::take(const libperf::Tracker& tracker) noexcept
+{
+	if(libperf_snapshot_take(tracker.handle(), &this->_snapshot) != LIBPERF_EXIT_SUCCESS)
+	{
+		this->_snapshot.mask = 0 ;
+		this->_snapshot.count = 0 ;
+		return false ;
+	}
+
+	return true ;
+}
+
+std::size_t libperf::Snapshot::size() const noexcept
+{
+	return this->_snapshot.count ;
+}
+
+int libperf::Snapshot::index(const libperf_event event) const noexcept
+{
+	return libperf_snapshot_index(&this->_snapshot, event) ;
+}
+
+libperf_event libperf::Snapshot::event(const std::size_t index) const noexcept
+{
+	return this->_snapshot.events[index] ;
+}
+
+const std::uint64_t* libperf::Snapshot::values() const noexcept
+{
+	return this->_snapshot.values ;
+}
+
+const std::uint64_t* libperf::Snapshot::time_enabled() const noexcept
+{
+	return this->_snapshot.time_enabled ;
+}
+
+const std::uint64_t* libperf::Snapshot::time_running() const noexcept
+{
+	return this->_snapshot.time_running ;
+}
+
+void libperf::Snapshot::scale(std::uint64_t *const scaled) const noexcept
+{
+	libperf_snapshot_scale(&this->_snapshot, scaled) ;
+}
+
+libperf::Snapshot libperf::Snapshot::operator-(const libperf::Snapshot& begin) const noexcept(false)
+{
+	libperf::Snapshot delta ;
+
+	const auto err = libperf_snapshot_delta(&begin._snapshot, &this->_snapshot, &delta._snapshot) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		throw std::system_error(err, libperf::Error()) ;
+	}
+
+	return delta ;
+}
+
+libperf::Snapshot& libperf::Snapshot::operator+=(const libperf::Snapshot& delta) noexcept(false)
+{
+	const auto err = libperf_snapshot_accumulate(&this->_snapshot, &delta._snapshot) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		throw std::system_error(err, libperf::Error()) ;
+	}
+
+	return *this ;
+}
+
+const libperf_snapshot& libperf::Snapshot::data() const noexcept
+{
+	return this->_snapshot ;
 }
@@ -8,17 +8,23 @@ extern "C" {
 #include <stdbool.h> // needed for boolean support
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
 
 /**
  * @brief Declarations of libperf API
  * @note See https://man7.org/linux/man-pages/man2/perf_event_open.2.html for constructs this library wraps
+ * @note Concurrency: a tracker may be shared between threads once initialised. Reads (libperf_read_*, libperf_snapshot_take, libperf_log) never lock, so any number may run at once; toggles are serialised by a per-tracker mutex, publishing which counters are enabled through an atomic bitmap, so never block readers. libperf_set_read_mode() should be settled before sharing, and libperf_fini() only called once no other thread uses the tracker
  * @author Salih MSA, Wolfgang Richter, Vincent Bernardoff 
  */
 
 struct libperf_tracker;
 typedef struct libperf_tracker libperf_tracker;
 
+struct perf_event_attr; // see linux/perf_event.h
+
 enum libperf_event {
 	/* struct aligns with entrys in perf events attribute struct */
 	/* sw tracepoints */
@@ -74,7 +80,27 @@ enum libperf_event {
 
 	/* Special internally defined "counter" */
 	/* this is the _only_ floating point value */
-	LIBPERF_LIB_SW_WALL_TIME = 33
+	LIBPERF_LIB_SW_WALL_TIME = 33,
+
+	/* Caller-defined events (see libperf_init_explicit), the k'th being LIBPERF_EVENT_CUSTOM + k */
+	LIBPERF_EVENT_CUSTOM = 34
+};
+
+#define LIBPERF_EVENT_CUSTOM_MAX 30 // number of caller-defined events a tracker can hold
+#define LIBPERF_EVENT_CUSTOM_N(k) ((enum libperf_event)(LIBPERF_EVENT_CUSTOM + (k))) // k'th caller-defined event
+#define LIBPERF_EVENT_SLOTS 64 // number of entries in arrays indexed by enum libperf_event
+
+#define LIBPERF_EVENT_MASK(event) (UINT64_C(1) << (event)) // bit selecting a perf event counter in an event mask
+#define LIBPERF_EVENT_MASK_ALL (LIBPERF_EVENT_MASK(LIBPERF_LIB_SW_WALL_TIME) - 1) // every perf event counter
+#define LIBPERF_EVENT_MASK_CUSTOM (~(LIBPERF_EVENT_MASK(LIBPERF_EVENT_CUSTOM) - 1)) // every caller-defined event
+
+enum libperf_init_flags {
+	LIBPERF_INIT_DEFAULT = 0, // open selected counters straight away
+	LIBPERF_INIT_LAZY = 1 << 0, // defer opening each selected counter until it's first toggled
+	LIBPERF_INIT_NO_INHERIT = 1 << 1, // only count the thread (or process) tracked, not children created after initialisation
+	LIBPERF_INIT_GROUP = 1 << 2, // open caller-defined events as one group, led by the first (see libperf_init_explicit)
+	LIBPERF_INIT_ENABLE_ON_EXEC = 1 << 3, // counters enable themselves when the tracked process next calls exec (e.g. a child forked to run a command), so none of the launcher is counted; can't be combined with LIBPERF_INIT_LAZY
+	LIBPERF_INIT_CGROUP = 1 << 4 // id is a file descriptor of a cgroup directory rather than a process, counting every task within it on a concrete cpu (see libperf_cpu_init_cgroup)
 };
 
 enum libperf_exit {
@@ -84,7 +110,9 @@ enum libperf_exit {
 	LIBPERF_EXIT_COUNTER_UNINITIALISABLE = 3,
 	LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED = 4,
 	LIBPERF_EXIT_HANDLE_INVALID = 5,
-	LIBPERF_EXIT_COUNTER_DISABLED = 6
+	LIBPERF_EXIT_COUNTER_DISABLED = 6,
+	LIBPERF_EXIT_GROUP_INVALID = 7,
+	LIBPERF_EXIT_READ_MODE_UNSUPPORTED = 8
 };
 
 enum libperf_event_toggle {
@@ -96,6 +124,68 @@ enum libperf_event_toggle {
 	LIBPERF_EVENT_TOGGLE_OUTPUT = 5 // allows pausing and resuming the event's ring-buffer ; pausing does not prevent generation but simply discards them
 } ;
 
+struct libperf_counter_value {
+	uint64_t raw; // count accumulated while actually on the PMU
+	uint64_t time_enabled; // nanoseconds counter has been enabled
+	uint64_t time_running; // nanoseconds counter was actually on the PMU; less than time_enabled if the kernel multiplexed it
+	uint64_t scaled; // estimate of count had it run the whole time it was enabled (ie raw * time_enabled / time_running)
+};
+
+#define LIBPERF_SNAPSHOT_MAX LIBPERF_EVENT_SLOTS // most entries a snapshot holds, ie every counter a tracker can have
+
+struct libperf_snapshot { /* counters of a tracker at one point in time, laid out as a structure of arrays so deltas & sums are plain vector loops */
+	uint64_t values[LIBPERF_SNAPSHOT_MAX]; // raw counts
+	uint64_t time_enabled[LIBPERF_SNAPSHOT_MAX]; // nanoseconds each counter has been enabled
+	uint64_t time_running[LIBPERF_SNAPSHOT_MAX]; // nanoseconds each counter was actually on the PMU
+	enum libperf_event events[LIBPERF_SNAPSHOT_MAX]; // event of each entry
+	uint64_t mask; // events covered (see LIBPERF_EVENT_MASK), so snapshots of differing trackers aren't mixed up
+	size_t count; // number of entries; only these are meaningful
+} __attribute__((aligned(64))); // each array starts on its own cache line
+
+enum libperf_read_mode {
+	LIBPERF_READ_MODE_SYSCALL = 0, // read counters with the read() syscall
+	LIBPERF_READ_MODE_RDPMC = 1 // read counters from userspace with rdpmc where the PMU allows it, falling back to read() otherwise
+};
+
+/**
+ * @brief libperf_diag_sink - receives diagnostic messages
+ * @param const int level - syslog level of message (e.g. LOG_ERR)
+ * @param const char *const message - nul terminated message, only valid during the call
+ * @param void *const context - pointer given to libperf_set_diag_sink()
+ * @note May be called from several threads at once, including the monitor's (see libperf_monitor.h)
+ */
+typedef void (*libperf_diag_sink)(const int level, const char *const message, void *const context);
+
+/**
+ * @brief libperf_set_diag_sink - function directs libperf's diagnostic messages somewhere other than syslog (the default)
+ * @note Messages less severe than LIBPERF_DIAG_LEVEL (LOG_WARNING unless defined otherwise when building libperf) aren't compiled in, so successful calls never log. At most LIBPERF_DIAG_RATE (16) messages a second reach the sink; the rest are counted and reported by a later message
+ * @param const libperf_diag_sink sink - function to pass messages to, or NULL to discard them
+ * @param void *const context - passed to every call of sink
+ */
+void libperf_set_diag_sink(const libperf_diag_sink sink, void *const context);
+
+/**
+ * @brief libperf_set_diag_level - function filters out diagnostic messages less severe than a level, at runtime
+ * @param const int level - syslog level (e.g. LOG_ERR to only see errors)
+ */
+void libperf_set_diag_level(const int level);
+
+/**
+ * @brief libperf_event_name - function obtains the name libperf uses for a counter (e.g. "HW_CPU_CYCLES")
+ * @param const enum libperf_event event - counter type
+ * @return const char* - name, or NULL if counter is invalid
+ */
+const char *libperf_event_name(const enum libperf_event event);
+
+/**
+ * @brief libperf_event_attr - function obtains the perf attributes libperf uses to describe a counter
+ * @note Useful as a starting point for configuring events yourself
+ * @param const enum libperf_event event - counter type (special library counters are not supported)
+ * @param struct perf_event_attr *const attr - attributes to write out to; only type, config & size are set, all other fields are zeroed
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_event_attr(const enum libperf_event event, struct perf_event_attr *const attr);
+
 /**
  * @brief libperf_init - function initialises the libperf library. Specifically, it initialises a set of provided trackers
  * @param const pid_t id - process ID *or* thread ID to monitor
@@ -107,6 +197,52 @@ enum libperf_event_toggle {
  */
 libperf_tracker *libperf_init(const pid_t id, const int cpu);
 
+/**
+ * @brief libperf_init_selective - function initialises the libperf library, opening only the counters selected
+ * @note Every counter opened costs a file descriptor & a perf_event_open() syscall, so select only the counters you intend to use
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @note Set -1 for system wide readings, or a cgroup directory's file descriptor with LIBPERF_INIT_CGROUP
+ * @param const int cpu - pass in specific cpuid to track
+ * @note Set -1 for aggregate readings (of all CPUs)
+ * @param const uint64_t events - mask of counters to open, built with LIBPERF_EVENT_MASK(); any other counter is treated as uninitialisable
+ * @param const unsigned int flags - bitwise OR of enum libperf_init_flags
+ * @note With LIBPERF_INIT_LAZY, nothing is opened here: each selected counter is opened on its first libperf_toggle_counter() call, which reports errors opening it. Until then it reads as disabled
+ * @return libperf_tracker* - handle for use in future library calls
+ * @note return NULL if failure occurs, on the same terms as libperf_init()
+ */
+libperf_tracker *libperf_init_selective(const pid_t id, const int cpu, const uint64_t events, const unsigned int flags);
+
+/**
+ * @brief libperf_init_group - function initialises the libperf library with a single group of events
+ * @note Members are opened under one leader (the first event), so the kernel schedules them onto the PMU together and libperf_read_group() obtains all of them with one syscall over the exact same interval
+ * @note Only the events supplied are opened. Unlike libperf_init, every member must be opened successfully, as a partial group would defeat the point of measuring them together
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @note Set -1 for system wide readings
+ * @param const int cpu - pass in specific cpuid to track
+ * @note Set -1 for aggregate readings (of all CPUs)
+ * @param const enum libperf_event *const events - members of the group, leader first (special library counters can't be grouped)
+ * @param const size_t count - number of members
+ * @return libperf_tracker* - handle for use in future library calls
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_tracker *libperf_init_group(const pid_t id, const int cpu, const enum libperf_event *const events, const size_t count);
+
+/**
+ * @brief libperf_init_explicit - function initialises the libperf library with events described by the caller
+ * @note Reaches events beyond enum libperf_event, e.g. raw PMU events (see libperf_pmu_parse() in libperf_pmu.h). The k'th attribute becomes event LIBPERF_EVENT_CUSTOM_N(k), used with the rest of the API like any other
+ * @note Attributes are taken as given (type, config, exclude_*, inherit, precise_ip, ...), except that size, disabled & read_format are set as libperf needs
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @note Set -1 for system wide readings
+ * @param const int cpu - pass in specific cpuid to track
+ * @note Set -1 for aggregate readings (of all CPUs)
+ * @param const struct perf_event_attr *const attrs - attributes of events
+ * @param const size_t count - number of events, at most LIBPERF_EVENT_CUSTOM_MAX
+ * @param const unsigned int flags - bitwise OR of enum libperf_init_flags. With LIBPERF_INIT_GROUP, events form a group as in libperf_init_group() (and so can't be lazy); otherwise, as in libperf_init_selective(), unsupported events are skipped
+ * @return libperf_tracker* - handle for use in future library calls
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_tracker *libperf_init_explicit(const pid_t id, const int cpu, const struct perf_event_attr *const attrs, const size_t count, const unsigned int flags);
+
 /**
  * @brief libperf_toggle_counter - this function manipulates a specified counter
  * @param libperf_tracker *const pd - library structure obtained from libperf_initialise()
@@ -117,6 +253,25 @@ libperf_tracker *libperf_init(const pid_t id, const int cpu);
  */
 enum libperf_exit libperf_toggle_counter(libperf_tracker *const pd, const enum libperf_event counter, const enum libperf_event_toggle toggle_type, ...);
 
+/**
+ * @brief libperf_toggle_counters - function enables, disables or resets a set of counters at once
+ * @note When the set covers a whole group, a single ioctl on the leader (with PERF_IOC_FLAG_GROUP) acts on every member at the same instant; other counters in the set take an ioctl each
+ * @note Nothing is toggled unless every counter in the set is initialised (lazy counters are opened first)
+ * @param libperf_tracker *const pd - library structure obtained from libperf_initialise()
+ * @param const uint64_t events - mask of counters, built with LIBPERF_EVENT_MASK()
+ * @param const enum libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_toggle_counters(libperf_tracker *const pd, const uint64_t events, const enum libperf_event_toggle toggle_type);
+
+/**
+ * @brief libperf_toggle_process - function enables or disables every counter opened by the calling process, of all trackers, with one prctl()
+ * @note Meant for pausing & resuming measurement process-wide: libperf doesn't track the change, so counters must already have been enabled through libperf_toggle_counter(s) to be readable
+ * @param const enum libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON or LIBPERF_EVENT_TOGGLE_OFF
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_toggle_process(const enum libperf_event_toggle toggle_type);
+
 /**
  * @brief libperf_readcounter - funtion reads a specified counter
  * @note You might want to use this, instead of the logging function, if you a) want to see the numbers real-time, b) only plan on recording one or two values
@@ -128,8 +283,121 @@ enum libperf_exit libperf_toggle_counter(libperf_tracker *const pd, const enum l
  */
 enum libperf_exit libperf_read_counter(libperf_tracker *const pd, const enum libperf_event counter, uint64_t *const value);
 
+/**
+ * @brief libperf_read_group - function reads every member of a group with a single syscall
+ * @note Values form a consistent snapshot, all measured over the same interval
+ * @note With LIBPERF_READ_MODE_RDPMC (see libperf_set_read_mode()), members are instead read back to back from userspace where possible
+ * @pre libperf_init_group(...) - tracker must have been initialised as a group
+ * @pre libperf_toggle_counter(..., counter, true) - enable counters
+ * @param libperf_tracker *const pd - library structure obtained from libperf_init_group()
+ * @param uint64_t *const values - array to write values out to, in the order members were supplied to libperf_init_group()
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_read_group(libperf_tracker *const pd, uint64_t *const values);
+
+/**
+ * @brief libperf_read_counter_scaled - funtion reads a specified counter, alongside how long it was enabled for & actually counting
+ * @note When more events are enabled than the PMU has slots, the kernel multiplexes them, so raw values undercount. Use the scaled estimate, or the running time, to account for this
+ * @pre libperf_toggle_counter(..., counter, true) - enable counters
+ * @param libperf_tracker *const pd - library structure obtained from libperf_initialise()
+ * @param const enum libperf_event counter - counter type (special library counters are not supported)
+ * @param struct libperf_counter_value *const value - value to write value out to
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_read_counter_scaled(libperf_tracker *const pd, const enum libperf_event counter, struct libperf_counter_value *const value);
+
+/**
+ * @brief libperf_read_group_scaled - function reads every member of a group with a single syscall, alongside how long the group was enabled for & actually counting
+ * @pre libperf_init_group(...) - tracker must have been initialised as a group
+ * @pre libperf_toggle_counter(..., counter, true) - enable counters
+ * @param libperf_tracker *const pd - library structure obtained from libperf_init_group()
+ * @param struct libperf_counter_value *const values - array to write values out to, in the order members were supplied to libperf_init_group()
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_read_group_scaled(libperf_tracker *const pd, struct libperf_counter_value *const values);
+
+/**
+ * @brief libperf_read_enabled - function reads every counter which is currently enabled
+ * @note Grouped trackers are read with a single syscall, others a counter at a time
+ * @param libperf_tracker *const pd - library structure obtained from libperf_initialise()
+ * @param uint64_t *const events - mask (see LIBPERF_EVENT_MASK) to write out which counters were read
+ * @param uint64_t *const values - array indexed by enum libperf_event (ie of LIBPERF_EVENT_SLOTS entries) to write raw values out to; entries not in events are left untouched
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_read_enabled(libperf_tracker *const pd, uint64_t *const events, uint64_t *const values);
+
+/**
+ * @brief libperf_snapshot_take - function reads every counter of a tracker into a snapshot
+ * @note Entries are a group's members in the order supplied (read with a single syscall), or otherwise every counter selected at initialisation in enum order, so successive snapshots of a tracker line up. Disabled counters read as they were last left, and counters still pending (see LIBPERF_INIT_LAZY) as 0
+ * @note Ungrouped counters are read as with libperf_read_counter_scaled(), so without syscalls where possible under LIBPERF_READ_MODE_RDPMC. Nothing is allocated
+ * @param libperf_tracker *const pd - library structure obtained from libperf_initialise()
+ * @param struct libperf_snapshot *const snapshot - snapshot to write out to
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_snapshot_take(libperf_tracker *const pd, struct libperf_snapshot *const snapshot);
+
+/**
+ * @brief libperf_snapshot_delta - function obtains how much each counter advanced from one snapshot to another
+ * @param const struct libperf_snapshot *const begin - earlier snapshot
+ * @param const struct libperf_snapshot *const end - later snapshot of the same tracker
+ * @param struct libperf_snapshot *const delta - snapshot to write end - begin out to (may be either of the others)
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_COUNTER_INVALID if the snapshots cover different events
+ */
+enum libperf_exit libperf_snapshot_delta(const struct libperf_snapshot *const begin, const struct libperf_snapshot *const end, struct libperf_snapshot *const delta);
+
+/**
+ * @brief libperf_snapshot_accumulate - function adds a snapshot (typically a delta) onto a running total
+ * @note A total with no entries (e.g. zero initialised) takes on the layout of what's added to it
+ * @param struct libperf_snapshot *const total - running total to add to
+ * @param const struct libperf_snapshot *const delta - snapshot to add
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_COUNTER_INVALID if the snapshots cover different events
+ */
+enum libperf_exit libperf_snapshot_accumulate(struct libperf_snapshot *const total, const struct libperf_snapshot *const delta);
+
+/**
+ * @brief libperf_snapshot_scale - function estimates each counter's value had it run the whole time it was enabled, as in struct libperf_counter_value
+ * @note Scaling a delta, rather than taking the delta of scaled values, accounts for multiplexing over just that interval
+ * @param const struct libperf_snapshot *const snapshot - snapshot to scale
+ * @param uint64_t *const scaled - array of snapshot->count entries to write estimates out to
+ */
+void libperf_snapshot_scale(const struct libperf_snapshot *const snapshot, uint64_t *const scaled);
+
+/**
+ * @brief libperf_snapshot_index - function finds which entry of a snapshot holds an event
+ * @param const struct libperf_snapshot *const snapshot - snapshot to search
+ * @param const enum libperf_event event - event to find
+ * @return int - index of entry, or -1 if the event isn't covered
+ */
+int libperf_snapshot_index(const struct libperf_snapshot *const snapshot, const enum libperf_event event);
+
+/**
+ * @brief libperf_set_read_mode - function selects how libperf_read_counter() obtains values
+ * @note LIBPERF_READ_MODE_RDPMC maps each counter's perf_event_mmap_page, so that reads of hardware counters currently scheduled on the PMU cost tens of cycles rather than a syscall. Software events, counters which aren't scheduled in, and systems which disallow rdpmc (see /sys/bus/event_source/devices/cpu/rdpmc) transparently fall back to read()
+ * @note A userspace read only covers the tracked thread itself, not children which inherited the counter
+ * @pre Tracker must monitor the calling thread (id of 0 or its thread ID) on any CPU (cpu of -1)
+ * @param libperf_tracker *const pd - library structure obtained from libperf_initialise()
+ * @param const enum libperf_read_mode mode - how to read counters
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_set_read_mode(libperf_tracker *const pd, const enum libperf_read_mode mode);
+
+/**
+ * @brief libperf_get_read_mode - function obtains how libperf_read_counter() obtains values
+ * @param const libperf_tracker *const pd - library structure obtained from libperf_initialise()
+ * @return enum libperf_read_mode - read mode last set (LIBPERF_READ_MODE_SYSCALL by default, or if the handle is invalid)
+ */
+enum libperf_read_mode libperf_get_read_mode(const libperf_tracker *const pd);
+
+/**
+ * @brief libperf_group_size - function obtains how many members a group has
+ * @param const libperf_tracker *const pd - library structure obtained from libperf_init_group()
+ * @return size_t - number of members, ie number of values libperf_read_group() writes out; 0 if tracker isn't a group
+ */
+size_t libperf_group_size(const libperf_tracker *const pd);
+
 /**
  * @brief libperf_log - logs values of all counters for debugging/logging purposes
+ * @note Each raw value is followed by the percentage of its enabled time it was actually counting for
  * @pre libperf_toggle_counter(..., counter, true) - enable counters
  * @param libperf_tracker *const pd - library structure obtained from libperf_initialise()
  * @param FILE *const stream - output stream for logging
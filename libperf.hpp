@@ -5,7 +5,9 @@
 #include <cstddef>
 #include <cstdio>
 #include <cstdint>
+#include <initializer_list>
 #include <string>
+#include <system_error>
 
 #include "libperf.h"
 
@@ -13,6 +15,7 @@
  * @brief Declarations of libperf API for C++
  * @note Access to libperf in C++ in via an RAII-complaint container
  * @note See https://man7.org/linux/man-pages/man2/perf_event_open.2.html for constructs this library (re)wraps
+ * @note Thread safety is as with the C API: const methods (reads) may be called from many threads at once, toggles are serialised
  * @author Salih MSA
  */
 
@@ -43,6 +46,45 @@ namespace libperf {
 			 */
 			explicit Tracker(const pid_t id, const int cpu) noexcept(false) ;
 
+			/**
+			 * @brief Tracker (constructor) - initialises the libperf tracker, opening only the counters selected
+			 * @note Stub to libperf_init_selective()
+			 * @param const pid_t id - process ID *or* thread ID to monitor
+			 * @note Set -1 for system wide readings
+			 * @brief const int cpu - pass in specific cpuid to track
+			 * @note Set -1 for aggregate readings (of all CPUs)
+			 * @param const std::uint64_t events - mask of counters to open, built with LIBPERF_EVENT_MASK()
+			 * @param const unsigned int flags - bitwise OR of libperf_init_flags (e.g. LIBPERF_INIT_LAZY to open each counter on first toggle)
+			 * @throws std::system_error - on the same terms as the default constructor
+			 */
+			explicit Tracker(const pid_t id, const int cpu, const std::uint64_t events, const unsigned int flags = LIBPERF_INIT_DEFAULT) noexcept(false) ;
+
+			/**
+			 * @brief Tracker (constructor) - initialises the libperf tracker with a single group of events
+			 * @note Stub to libperf_init_group()
+			 * @param const pid_t id - process ID *or* thread ID to monitor
+			 * @note Set -1 for system wide readings
+			 * @brief const int cpu - pass in specific cpuid to track
+			 * @note Set -1 for aggregate readings (of all CPUs)
+			 * @param std::initializer_list<libperf_event> group - members of the group, leader first
+			 * @throws std::system_error - thrown if any member couldn't be opened. We throw the errno which caused the specific error
+			 */
+			explicit Tracker(const pid_t id, const int cpu, std::initializer_list<libperf_event> group) noexcept(false) ;
+
+			/**
+			 * @brief Tracker (constructor) - initialises the libperf tracker with events described by the caller
+			 * @note Stub to libperf_init_explicit(). The k'th attribute becomes event LIBPERF_EVENT_CUSTOM_N(k)
+			 * @param const pid_t id - process ID *or* thread ID to monitor
+			 * @note Set -1 for system wide readings
+			 * @brief const int cpu - pass in specific cpuid to track
+			 * @note Set -1 for aggregate readings (of all CPUs)
+			 * @param const perf_event_attr *const attrs - attributes of events (e.g. from libperf::pmu_parse())
+			 * @param const std::size_t count - number of events, at most LIBPERF_EVENT_CUSTOM_MAX
+			 * @param const unsigned int flags - bitwise OR of libperf_init_flags (e.g. LIBPERF_INIT_GROUP to open them as one group)
+			 * @throws std::system_error - thrown if the tracker couldn't be initialised. We throw the errno which caused the specific error
+			 */
+			explicit Tracker(const pid_t id, const int cpu, const perf_event_attr *const attrs, const std::size_t count, const unsigned int flags = LIBPERF_INIT_DEFAULT) noexcept(false) ;
+
 			/**
 			 * @note Copy constructor + assignment deleted - there are so few scenarios where copying either the file handle (to watch the exact same events) or accessing the attributes would be desirable
 			 * So I've explicitly deleted it
@@ -57,9 +99,9 @@ namespace libperf {
 			explicit Tracker(Tracker&& tracker) noexcept ;
 
 			/**
-			 * @brief Tracker (move constructor) - acquire existing libperf tracker
+			 * @brief operator= (move assignment) - acquire existing libperf tracker, shutting down the one held
 			 * @param Tracker&& tracker - tracker to acquire
-			 * @return Tracker& - new object which acquired
+			 * @return Tracker& - object which acquired
 			 */
 			Tracker& operator=(Tracker&& tracker) noexcept ;
 
@@ -74,6 +116,25 @@ namespace libperf {
 			 */
 			void toggle_counter(const libperf_event counter, const libperf_event_toggle toggle_type, ...) noexcept(false) ;
 
+			/**
+			 * @brief toggle_counters - method enables, disables or resets a set of counters at once
+			 * @note Stub to libperf_toggle_counters()
+			 * @param const std::uint64_t events - mask of counters, built with LIBPERF_EVENT_MASK()
+			 * @param const libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+			 * @throws std::system_error - thrown if we can't manipulate counters
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error. The former is when a system error occured, and the latter when there was an issue with the library. Whichever one of them is assigned depends on the underlying C API
+			 */
+			void toggle_counters(const std::uint64_t events, const libperf_event_toggle toggle_type) noexcept(false) ;
+
+			/**
+			 * @brief toggle_process - enables or disables every counter opened by the calling process, of all trackers
+			 * @note Stub to libperf_toggle_process()
+			 * @param const libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON or LIBPERF_EVENT_TOGGLE_OFF
+			 * @throws std::system_error - thrown if we can't manipulate counters
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			static void toggle_process(const libperf_event_toggle toggle_type) noexcept(false) ;
+
 			/**
 			 * @brief read_counter - method reads a specified counter
 			 * @note You might want to use this, instead of the logging function, if you a) want to see the numbers real-time, b) only plan on recording one or two values
@@ -86,6 +147,78 @@ namespace libperf {
 			 */
 			std::uint64_t read_counter(const libperf_event counter) const noexcept(false) ;
 
+			/**
+			 * @brief read_group - method reads every member of the group with a single syscall
+			 * @note Stub to libperf_read_group()
+			 * @pre Tracker constructed with a group
+			 * @param std::uint64_t *const values - array to write values out to, in the order members were supplied to the constructor
+			 * @throws std::system_error - thrown if we can't read values
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error. The former is when a system error occured, and the latter when there was an issue with the library. Whichever one of them is assigned depends on the underlying C API
+			 */
+			void read_group(std::uint64_t *const values) const noexcept(false) ;
+
+			/**
+			 * @brief read_counter_scaled - method reads a specified counter, alongside how long it was enabled for & actually counting
+			 * @note Stub to libperf_read_counter_scaled()
+			 * @pre this->toggle_counter(counter, true) - enable counter
+			 * @param const libperf_event counter - counter type
+			 * @return libperf_counter_value - raw value, enabled & running times, and the estimate scaled to account for multiplexing
+			 * @throws std::system_error - thrown if we can't read value
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error. The former is when a system error occured, and the latter when there was an issue with the library. Whichever one of them is assigned depends on the underlying C API
+			 */
+			libperf_counter_value read_counter_scaled(const libperf_event counter) const noexcept(false) ;
+
+			/**
+			 * @brief read_group_scaled - method reads every member of the group with a single syscall, alongside how long the group was enabled for & actually counting
+			 * @note Stub to libperf_read_group_scaled()
+			 * @pre Tracker constructed with a group
+			 * @param libperf_counter_value *const values - array to write values out to, in the order members were supplied to the constructor
+			 * @throws std::system_error - thrown if we can't read values
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error. The former is when a system error occured, and the latter when there was an issue with the library. Whichever one of them is assigned depends on the underlying C API
+			 */
+			void read_group_scaled(libperf_counter_value *const values) const noexcept(false) ;
+
+			/**
+			 * @brief read_enabled - method reads every counter which is currently enabled
+			 * @note Stub to libperf_read_enabled()
+			 * @param std::uint64_t *const values - array indexed by libperf_event (ie of LIBPERF_EVENT_SLOTS entries) to write raw values out to
+			 * @return std::uint64_t - mask (see LIBPERF_EVENT_MASK) of which counters were read
+			 * @throws std::system_error - thrown if we can't read values
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error. The former is when a system error occured, and the latter when there was an issue with the library. Whichever one of them is assigned depends on the underlying C API
+			 */
+			std::uint64_t read_enabled(std::uint64_t *const values) const noexcept(false) ;
+
+			/**
+			 * @brief set_read_mode - method selects how read_counter() obtains values
+			 * @note Stub to libperf_set_read_mode()
+			 * @note libperf_read_mode::LIBPERF_READ_MODE_RDPMC reads hardware counters from userspace, falling back to a syscall when unavailable
+			 * @pre Tracker must monitor the calling thread (id of 0 or its thread ID) on any CPU (cpu of -1)
+			 * @param const libperf_read_mode mode - how to read counters
+			 * @throws std::system_error - thrown if read mode can't be used for this tracker
+			 * @note Category of std::system_error will be libperf::Error
+			 */
+			void set_read_mode(const libperf_read_mode mode) noexcept(false) ;
+
+			/**
+			 * @brief read_mode - method obtains how read_counter() obtains values
+			 * @note Stub to libperf_get_read_mode()
+			 * @return libperf_read_mode - read mode last set
+			 */
+			libperf_read_mode read_mode() const noexcept ;
+
+			/**
+			 * @brief group_size - method obtains how many members the group has
+			 * @note Stub to libperf_group_size()
+			 * @return std::size_t - number of members, ie number of values read_group() writes out; 0 if not a group
+			 */
+			std::size_t group_size() const noexcept ;
+
+			/**
+			 * @brief handle - method obtains the underlying C API handle, for use with the parts of libperf which build upon it
+			 * @return libperf_tracker* - handle, still owned by this object
+			 */
+			libperf_tracker* handle() const noexcept ;
+
 			/**
 			 * @brief log - logs values of all counters for debugging/logging purposes
 			 * @note Stub to libperf_log()
@@ -104,6 +237,107 @@ namespace libperf {
 
 	} ;
 
+	class Snapshot {
+		private:
+			libperf_snapshot _snapshot ; // values, enabled & running times as plain arrays
+
+		public:
+			/**
+			 * @brief Snapshot (constructor) - creates an empty snapshot, e.g. a running total to accumulate into
+			 */
+			Snapshot() noexcept ;
+
+			/**
+			 * @brief Snapshot (constructor) - reads every counter of a tracker
+			 * @note Stub to libperf_snapshot_take()
+			 * @param const Tracker& tracker - tracker to read
+			 * @throws std::system_error - thrown if we can't read values
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			explicit Snapshot(const Tracker& tracker) noexcept(false) ;
+
+			/**
+			 * @brief take - method reads every counter of a tracker, without throwing
+			 * @note Stub to libperf_snapshot_take(). Suits hot paths, as nothing is allocated either
+			 * @param const Tracker& tracker - tracker to read
+			 * @return bool - whether counters were read; if not, the snapshot is left empty
+			 */
+			bool take(const Tracker& tracker) noexcept ;
+
+			/**
+			 * @brief size - method obtains how many entries the snapshot holds
+			 * @return std::size_t - number of entries
+			 */
+			std::size_t size() const noexcept ;
+
+			/**
+			 * @brief index - method finds which entry holds an event
+			 * @note Stub to libperf_snapshot_index()
+			 * @param const libperf_event event - event to find
+			 * @return int - index of entry, or -1 if the event isn't covered
+			 */
+			int index(const libperf_event event) const noexcept ;
+
+			/**
+			 * @brief event - method obtains the event of an entry
+			 * @param const std::size_t index - index of entry, less than size()
+			 * @return libperf_event - event
+			 */
+			libperf_event event(const std::size_t index) const noexcept ;
+
+			/**
+			 * @brief values - method obtains the raw counts, as an array of size() entries
+			 * @return const std::uint64_t* - raw counts
+			 */
+			const std::uint64_t* values() const noexcept ;
+
+			/**
+			 * @brief time_enabled - method obtains how long each counter has been enabled, as an array of size() entries
+			 * @return const std::uint64_t* - nanoseconds
+			 */
+			const std::uint64_t* time_enabled() const noexcept ;
+
+			/**
+			 * @brief time_running - method obtains how long each counter was actually on the PMU, as an array of size() entries
+			 * @return const std::uint64_t* - nanoseconds
+			 */
+			const std::uint64_t* time_running() const noexcept ;
+
+			/**
+			 * @brief scale - method estimates each counter's value had it run the whole time it was enabled
+			 * @note Stub to libperf_snapshot_scale()
+			 * @param std::uint64_t *const scaled - array of size() entries to write estimates out to
+			 */
+			void scale(std::uint64_t *const scaled) const noexcept ;
+
+			/**
+			 * @brief operator- - obtains how much each counter advanced since an earlier snapshot
+			 * @note Stub to libperf_snapshot_delta()
+			 * @param const Snapshot& begin - earlier snapshot of the same tracker
+			 * @return Snapshot - *this - begin
+			 * @throws std::system_error - thrown if the snapshots cover different events
+			 * @note Category of std::system_error will be libperf::Error
+			 */
+			Snapshot operator-(const Snapshot& begin) const noexcept(false) ;
+
+			/**
+			 * @brief operator+= - adds a snapshot (typically a delta) onto this one
+			 * @note Stub to libperf_snapshot_accumulate(). An empty snapshot takes on the layout of what's added to it
+			 * @param const Snapshot& delta - snapshot to add
+			 * @return Snapshot& - this snapshot
+			 * @throws std::system_error - thrown if the snapshots cover different events
+			 * @note Category of std::system_error will be libperf::Error
+			 */
+			Snapshot& operator+=(const Snapshot& delta) noexcept(false) ;
+
+			/**
+			 * @brief data - method obtains the underlying C API snapshot, for use with the parts of libperf which build upon it
+			 * @return const libperf_snapshot& - snapshot
+			 */
+			const libperf_snapshot& data() const noexcept ;
+
+	} ;
+
 } // libperf
 
 #endif // LIBPERF_HPP
@@ -0,0 +1,330 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <ctime>
+
+#include <sched.h>
+
+#include "libperf.h"
+
+#include "libperf_bench.hpp"
+
+/**
+ * @brief Definitions of libperf microbenchmark harness in C++
+ * @author Salih MSA
+ */
+
+const std::size_t libperf::Bench::max_benchmarks ;
+const std::size_t libperf::Bench::max_events ;
+const std::size_t libperf::Bench::max_samples ;
+
+namespace {
+
+	struct Benchmark {
+		const char* name ;
+		libperf::Bench::Function function ;
+	} ;
+
+	/* registry is constant initialised, so is usable by benchmarks registered during static initialisation */
+	Benchmark registry[libperf::Bench::max_benchmarks] ;
+	std::atomic<std::size_t> registered(0) ;
+
+	const double mad_normalisation = 1.4826 ; // makes MAD comparable to a standard deviation for normally distributed samples
+
+	inline std::uint64_t now() noexcept
+	{
+		struct timespec ts ;
+		clock_gettime(CLOCK_MONOTONIC, &ts) ;
+		return static_cast<std::uint64_t>(ts.tv_sec) * UINT64_C(1000000000) + static_cast<std::uint64_t>(ts.tv_nsec) ;
+	}
+
+	inline std::uint64_t time_batch(const libperf::Bench::Function function, const std::uint64_t iterations) noexcept
+	{
+		const std::uint64_t begin = now() ;
+		function(iterations) ;
+		return now() - begin ;
+	}
+
+	double median(double *const values, const std::size_t count) noexcept
+	{
+		std::sort(values, values + count) ;
+		return count % 2 == 1 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2.0 ;
+	}
+
+	/**
+	 * @brief summarise - computes median & MAD of samples, then again once samples too far from the median are rejected
+	 * @param const double *const samples - samples; NaN ones (e.g. batches a counter didn't run for) are skipped
+	 * @param const std::size_t count - number of samples
+	 * @param const double outlier - samples more than this many normalised MADs from the median are rejected
+	 * @return libperf::Bench::Statistic - statistics of samples kept
+	 */
+	libperf::Bench::Statistic summarise(const double *const samples, const std::size_t count, const double outlier) noexcept
+	{
+		double sorted[libperf::Bench::max_samples] ;
+		double deviations[libperf::Bench::max_samples] ;
+		libperf::Bench::Statistic statistic = { NAN, NAN, NAN, NAN, 0 } ;
+
+		std::size_t valid = 0 ;
+		for(std::size_t i = 0 ; i < count ; ++i)
+		{
+			if(!std::isnan(samples[i]))
+			{
+				sorted[valid++] = samples[i] ;
+			}
+		}
+		if(valid == 0)
+		{
+			return statistic ;
+		}
+
+		const double centre = median(sorted, valid) ;
+		for(std::size_t i = 0 ; i < valid ; ++i)
+		{
+			deviations[i] = std::fabs(sorted[i] - centre) ;
+		}
+		const double limit = outlier * mad_normalisation * median(deviations, valid) ;
+
+		/* sorted, so those kept are contiguous */
+		std::size_t first = 0 ;
+		std::size_t last = valid ;
+		if(limit > 0.0)
+		{
+			while(centre - sorted[first] > limit) ++first ;
+			while(sorted[last - 1] - centre > limit) --last ;
+		}
+
+		statistic.kept = last - first ;
+		statistic.min = sorted[first] ;
+		statistic.max = sorted[last - 1] ;
+		statistic.median = median(sorted + first, statistic.kept) ;
+		for(std::size_t i = first ; i < last ; ++i)
+		{
+			deviations[i - first] = std::fabs(sorted[i] - statistic.median) ;
+		}
+		statistic.mad = median(deviations, statistic.kept) ;
+
+		return statistic ;
+	}
+
+	/**
+	 * @brief write_json - writes a statistic out as a JSON object member, NaN (which JSON lacks) as null
+	 * @param std::FILE *const stream - output stream
+	 * @param const char *const metric - name of member
+	 * @param const libperf::Bench::Statistic& statistic - statistic to write
+	 */
+	void write_json(std::FILE *const stream, const char *const metric, const libperf::Bench::Statistic& statistic) noexcept
+	{
+		if(std::isnan(statistic.median))
+		{
+			std::fprintf(stream, "\"%s\":null", metric) ;
+			return ;
+		}
+
+		std::fprintf(stream, "\"%s\":{\"median\":%.4f,\"mad\":%.4f,\"min\":%.4f,\"max\":%.4f,\"kept\":%zu}", metric, statistic.median, statistic.mad, statistic.min, statistic.max, statistic.kept) ;
+	}
+
+} // anonymous
+
+libperf::Bench::Options::Options() noexcept : cpu(sched_getcpu()), event_count(3), samples(31), warmup_ns(100000000), min_batch_ns(1000000), outlier(3.0), filter(nullptr), format(Format::TEXT)
+{
+	this->events[0] = LIBPERF_EVENT_HW_CPU_CYCLES ;
+	this->events[1] = LIBPERF_EVENT_HW_INSTRUCTIONS ;
+	this->events[2] = LIBPERF_EVENT_HW_CACHE_MISSES ;
+}
+
+libperf::Bench::Registration::Registration(const char *const name, const libperf::Bench::Function function) noexcept
+{
+	const std::size_t slot = registered.fetch_add(1, std::memory_order_relaxed) ;
+	if(slot < max_benchmarks)
+	{
+		registry[slot].name = name ;
+		registry[slot].function = function ;
+	}
+}
+
+bool libperf::Bench::run(const char *const name, const libperf::Bench::Function function, const libperf::Bench::Options& options, libperf::Bench::Result& result) noexcept
+{
+	if(function == nullptr || options.samples == 0 || options.samples > max_samples || options.event_count > max_events || options.cpu >= CPU_SETSIZE) // CPU_SET() is undefined beyond CPU_SETSIZE
+	{
+		return false ;
+	}
+
+	cpu_set_t previous ;
+	if(options.cpu >= 0)
+	{
+		cpu_set_t pinned ;
+		CPU_ZERO(&pinned) ;
+		CPU_SET(options.cpu, &pinned) ;
+		if(sched_getaffinity(0, sizeof(cpu_set_t), &previous) != 0 || sched_setaffinity(0, sizeof(cpu_set_t), &pinned) != 0)
+		{
+			return false ;
+		}
+	}
+
+	result.name = name ;
+	result.samples = options.samples ;
+
+	/* counters are optional: without them (e.g. in a VM without a PMU), wall time is still measured */
+	libperf_tracker *pd = nullptr ;
+	if(options.event_count != 0)
+	{
+		std::uint64_t mask = 0 ;
+		for(std::size_t i = 0 ; i < options.event_count ; ++i)
+		{
+			mask |= LIBPERF_EVENT_MASK(options.events[i]) ;
+		}
+
+		/* members are opened disabled, so the whole group is enabled at once (a single ioctl on the leader) */
+		pd = libperf_init_group(0, -1, options.events, options.event_count) ;
+		if(pd != nullptr && libperf_toggle_counters(pd, mask, LIBPERF_EVENT_TOGGLE_ON) != LIBPERF_EXIT_SUCCESS)
+		{
+			libperf_fini(pd) ;
+			pd = nullptr ;
+		}
+	}
+	result.event_count = pd == nullptr ? 0 : options.event_count ;
+	std::copy(options.events, options.events + result.event_count, result.events) ;
+
+	/* scale iterations until a batch is long enough that clock & counter reads are noise, warming up as we go */
+	std::uint64_t iterations = 1 ;
+	std::uint64_t warmed = 0 ;
+	for(;;)
+	{
+		const std::uint64_t elapsed = time_batch(function, iterations) ;
+		warmed += elapsed ;
+		if(elapsed >= options.min_batch_ns || iterations >= (UINT64_C(1) << 40))
+		{
+			break ;
+		}
+		iterations *= 2 ;
+	}
+	while(warmed < options.warmup_ns)
+	{
+		warmed += time_batch(function, iterations) ;
+	}
+	result.iterations = iterations ;
+
+	double wall[max_samples] ;
+	double counters[max_events][max_samples] ;
+	libperf_counter_value begin[max_events] ;
+	libperf_counter_value end[max_events] ;
+
+	for(std::size_t s = 0 ; s < options.samples ; ++s)
+	{
+		/* counters are read outside the timed window, so neither includes the other's overhead */
+		const bool counted = pd != nullptr && libperf_read_group_scaled(pd, begin) == LIBPERF_EXIT_SUCCESS ;
+		const std::uint64_t elapsed = time_batch(function, iterations) ;
+		const bool counted_end = counted && libperf_read_group_scaled(pd, end) == LIBPERF_EXIT_SUCCESS ;
+
+		wall[s] = static_cast<double>(elapsed) / static_cast<double>(iterations) ;
+
+		const std::uint64_t running = counted_end ? end[0].time_running - begin[0].time_running : 0 ;
+		const std::uint64_t enabled = counted_end ? end[0].time_enabled - begin[0].time_enabled : 0 ;
+		for(std::size_t i = 0 ; i < result.event_count ; ++i)
+		{
+			if(running == 0)
+			{ // group wasn't on the PMU at all during the batch, so there's nothing to scale
+				counters[i][s] = NAN ;
+				continue ;
+			}
+			const double raw = static_cast<double>(end[i].raw - begin[i].raw) ;
+			counters[i][s] = raw * static_cast<double>(enabled) / static_cast<double>(running) / static_cast<double>(iterations) ;
+		}
+	}
+
+	if(pd != nullptr)
+	{
+		libperf_fini(pd) ;
+	}
+	if(options.cpu >= 0)
+	{
+		sched_setaffinity(0, sizeof(cpu_set_t), &previous) ;
+	}
+
+	result.wall = summarise(wall, options.samples, options.outlier) ;
+	for(std::size_t i = 0 ; i < result.event_count ; ++i)
+	{
+		result.counters[i] = summarise(counters[i], options.samples, options.outlier) ;
+	}
+
+	return true ;
+}
+
+void libperf::Bench::report(std::FILE *const stream, const libperf::Bench::Result& result, const libperf::Bench::Format format) noexcept
+{
+	if(stream == nullptr)
+	{
+		return ;
+	}
+
+	switch(format)
+	{
+		case Format::CSV:
+			std::fprintf(stream, "%s,WALL_NS,%.4f,%.4f,%.4f,%.4f,%zu,%zu,%lu\n", result.name, result.wall.median, result.wall.mad, result.wall.min, result.wall.max, result.wall.kept, result.samples, result.iterations) ;
+			for(std::size_t i = 0 ; i < result.event_count ; ++i)
+			{
+				const Statistic& counter = result.counters[i] ;
+				std::fprintf(stream, "%s,%s,%.4f,%.4f,%.4f,%.4f,%zu,%zu,%lu\n", result.name, libperf_event_name(result.events[i]), counter.median, counter.mad, counter.min, counter.max, counter.kept, result.samples, result.iterations) ;
+			}
+			break ;
+		case Format::JSON:
+			std::fprintf(stream, "{\"benchmark\":\"%s\",\"samples\":%zu,\"iterations\":%lu,\"metrics\":{", result.name, result.samples, result.iterations) ;
+			write_json(stream, "WALL_NS", result.wall) ;
+			for(std::size_t i = 0 ; i < result.event_count ; ++i)
+			{
+				std::fputc(',', stream) ;
+				write_json(stream, libperf_event_name(result.events[i]), result.counters[i]) ;
+			}
+			std::fprintf(stream, "}}\n") ;
+			break ;
+		case Format::TEXT:
+		default:
+			std::fprintf(stream, "%s: %zu samples of %lu iterations\n", result.name, result.samples, result.iterations) ;
+			std::fprintf(stream, "\tWALL_NS: median %.4f mad %.4f min %.4f max %.4f (%zu kept)\n", result.wall.median, result.wall.mad, result.wall.min, result.wall.max, result.wall.kept) ;
+			for(std::size_t i = 0 ; i < result.event_count ; ++i)
+			{
+				const Statistic& counter = result.counters[i] ;
+				std::fprintf(stream, "\t%s: median %.4f mad %.4f min %.4f max %.4f (%zu kept)\n", libperf_event_name(result.events[i]), counter.median, counter.mad, counter.min, counter.max, counter.kept) ;
+			}
+			if(result.event_count == 0)
+			{
+				std::fprintf(stream, "\t(counters unavailable, wall time only)\n") ;
+			}
+			break ;
+	}
+
+	std::fflush(stream) ;
+}
+
+std::size_t libperf::Bench::run_all(const libperf::Bench::Options& options, std::FILE *const stream) noexcept
+{
+	const std::size_t benchmarks = std::min(registered.load(std::memory_order_relaxed), max_benchmarks) ;
+	std::size_t failed = 0 ;
+
+	if(options.format == Format::CSV && stream != nullptr)
+	{
+		std::fprintf(stream, "benchmark,metric,median,mad,min,max,kept,samples,iterations\n") ;
+	}
+
+	for(std::size_t b = 0 ; b < benchmarks ; ++b)
+	{
+		if(options.filter != nullptr && std::strstr(registry[b].name, options.filter) == nullptr)
+		{
+			continue ;
+		}
+
+		Result result ;
+		if(!run(registry[b].name, registry[b].function, options, result))
+		{
+			++failed ;
+			continue ;
+		}
+		report(stream, result, options.format) ;
+	}
+
+	return failed ;
+}
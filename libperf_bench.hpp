@@ -0,0 +1,136 @@
+#ifndef LIBPERF_BENCH_HPP
+#define LIBPERF_BENCH_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdint>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf microbenchmark harness for C++
+ * @note A benchmark is a function running the code under test a given number of times. The harness warms it up, scales the iteration count until a batch is long enough to time reliably, then measures batches on a pinned CPU - wall time & a group of counters, per iteration - rejects outliers and reports the median & median absolute deviation (MAD) of each
+ * @author Salih MSA
+ */
+
+#define LIBPERF_BENCH_CONCAT_(a, b) a##b
+#define LIBPERF_BENCH_CONCAT(a, b) LIBPERF_BENCH_CONCAT_(a, b)
+
+/**
+ * @brief LIBPERF_BENCHMARK - registers a function as a benchmark, named after it
+ * @param function - function of signature void(std::uint64_t iterations), running the code under test `iterations` times
+ */
+#define LIBPERF_BENCHMARK(function) \
+	static const libperf::Bench::Registration LIBPERF_BENCH_CONCAT(libperf_bench_registration_, __LINE__)(#function, function)
+
+namespace libperf {
+
+	/**
+	 * @brief do_not_optimize - stops the compiler discarding a value (and the computation producing it) as unused
+	 * @param const T& value - value to keep
+	 */
+	template<typename T>
+	inline void do_not_optimize(const T& value) noexcept
+	{
+		asm volatile("" : : "r,m"(value) : "memory") ;
+	}
+
+	/**
+	 * @brief clobber_memory - stops the compiler eliding or reordering writes to memory across this point
+	 */
+	inline void clobber_memory() noexcept
+	{
+		asm volatile("" : : : "memory") ;
+	}
+
+	class Bench {
+		public:
+			static const std::size_t max_benchmarks = 256 ; // benchmarks which can be registered
+			static const std::size_t max_events = 8 ; // counters which can be measured alongside wall time
+			static const std::size_t max_samples = 1024 ; // batches which can be measured per benchmark
+
+			typedef void (*Function)(std::uint64_t iterations) ;
+
+			enum class Format {
+				TEXT = 0, // human readable
+				CSV = 1, // one line per benchmark & metric
+				JSON = 2 // one object per benchmark & line (JSON Lines)
+			} ;
+
+			struct Options {
+				int cpu ; // CPU to pin the calling thread to while measuring; -1 not to pin
+				libperf_event events[max_events] ; // group of counters to measure, leader first
+				std::size_t event_count ;
+				std::size_t samples ; // batches measured, at most max_samples
+				std::uint64_t warmup_ns ; // time spent running the benchmark before measuring
+				std::uint64_t min_batch_ns ; // iterations are doubled until a batch takes at least this long
+				double outlier ; // samples further than this many (normalised) MADs from the median are rejected
+				const char* filter ; // run_all() only runs benchmarks whose name contains this; nullptr for all
+				Format format ;
+
+				/**
+				 * @brief Options (constructor) - defaults: pinned to the CPU the caller is running on (see sched_getcpu()), or not pinned if that can't be determined, cycles, instructions & cache misses, 31 samples of at least 1ms after 100ms of warmup, outliers beyond 3 MADs
+				 */
+				Options() noexcept ;
+			} ;
+
+			struct Statistic {
+				double median ; // per iteration
+				double mad ; // median absolute deviation, per iteration
+				double min ; // smallest sample kept, per iteration
+				double max ; // largest sample kept, per iteration
+				std::size_t kept ; // samples left once outliers were rejected
+			} ;
+
+			struct Result {
+				const char* name ;
+				std::uint64_t iterations ; // iterations per sample
+				std::size_t samples ; // samples measured
+				Statistic wall ; // nanoseconds per iteration
+				std::size_t event_count ; // counters measured; 0 if the group couldn't be opened, in which case only wall time is
+				libperf_event events[max_events] ;
+				Statistic counters[max_events] ; // events per iteration, scaled if the kernel multiplexed the group
+			} ;
+
+			class Registration {
+				public:
+					/**
+					 * @brief Registration (constructor) - registers a benchmark for run_all(); see LIBPERF_BENCHMARK
+					 * @param const char *const name - name of benchmark, which must outlive it (e.g. a string literal)
+					 * @param const Function function - benchmark
+					 */
+					explicit Registration(const char *const name, const Function function) noexcept ;
+			} ;
+
+			/**
+			 * @brief run - measures a single benchmark
+			 * @param const char *const name - name of benchmark
+			 * @param const Function function - benchmark
+			 * @param const Options& options - how to measure
+			 * @param Result& result - result to write out to
+			 * @return bool - whether the benchmark was measured; false if the thread couldn't be pinned or the options are invalid
+			 */
+			static bool run(const char *const name, const Function function, const Options& options, Result& result) noexcept ;
+
+			/**
+			 * @brief report - writes a result out
+			 * @param std::FILE *const stream - output stream
+			 * @param const Result& result - result of run()
+			 * @param const Format format - format to write in
+			 */
+			static void report(std::FILE *const stream, const Result& result, const Format format) noexcept ;
+
+			/**
+			 * @brief run_all - measures every registered benchmark, reporting each as it completes
+			 * @param const Options& options - how to measure
+			 * @param std::FILE *const stream - output stream
+			 * @return std::size_t - number of benchmarks which couldn't be measured
+			 */
+			static std::size_t run_all(const Options& options, std::FILE *const stream) noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_BENCH_HPP
@@ -0,0 +1,207 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_binlog.h"
+
+/**
+ * @brief Definitions of libperf binary logging API and inner functionality
+ * @author Salih MSA
+ */
+
+#define LIBPERF_BINLOG_BUFFER 65536 // bytes of records held back before writing out
+
+struct libperf_binlog { /* lib struct */
+	int fd; // log file
+	uint64_t events; // events logged
+	size_t count; // number of events logged
+	size_t record_size; // size of header & values of each record
+	size_t used; // bytes of buffer holding records
+	size_t flushed; // bytes at the front of buffer already written out, should a flush have been cut short (kept in place, so record offsets stay aligned)
+	unsigned char buffer[LIBPERF_BINLOG_BUFFER];
+};
+
+static inline uint64_t libperf_binlog_clock(const clockid_t clock)
+{
+	struct timespec now;
+	clock_gettime(clock, &now);
+	return ((uint64_t)now.tv_sec * UINT64_C(1000000000)) + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief libperf_binlog_write_all - writes a whole buffer out, resuming after partial writes & interrupts
+ * @param const int fd - file to write to
+ * @param const void *const data - data to write
+ * @param const size_t size - size of data
+ * @return size_t - number of bytes written, which is less than size (with errno set) if an error cut it short
+ */
+static size_t libperf_binlog_write_all(const int fd, const void *const data, const size_t size)
+{
+	const unsigned char *cursor = data;
+	size_t remaining = size;
+
+	while (remaining > 0) {
+		const ssize_t written = write(fd, cursor, remaining);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return size - remaining;
+		}
+		cursor += written;
+		remaining -= (size_t)written;
+	}
+
+	return size;
+}
+
+libperf_binlog *libperf_binlog_open(const char *const path, const uint64_t events)
+{
+	const uint64_t logged = events & (LIBPERF_EVENT_MASK_ALL | LIBPERF_EVENT_MASK_CUSTOM);
+	if (path == NULL || logged == 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): no path or events supplied", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	libperf_binlog *log = malloc(sizeof(libperf_binlog));
+	if (log == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", __func__);
+		return NULL;
+	}
+
+	log->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+	if (log->fd < 0) {
+		const int err = errno;
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to open '%s'", __func__, path);
+		free(log);
+		errno = err;
+		return NULL;
+	}
+
+	log->events = logged;
+	log->count = (size_t)__builtin_popcountll(logged);
+	log->record_size = sizeof(struct libperf_binlog_record) + (log->count * sizeof(uint64_t));
+	log->used = 0;
+	log->flushed = 0;
+
+	/* header & names are staged in the buffer, so go out with the first batch of records */
+	struct libperf_binlog_header header;
+	memcpy(header.magic, LIBPERF_BINLOG_MAGIC, sizeof(header.magic));
+	header.version = LIBPERF_BINLOG_VERSION;
+	header.count = (uint32_t)log->count;
+	header.events = logged;
+	header.realtime = libperf_binlog_clock(CLOCK_REALTIME);
+	header.monotonic = libperf_binlog_clock(CLOCK_MONOTONIC);
+	memcpy(log->buffer, &header, sizeof(header));
+	log->used = sizeof(header);
+
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS; ++i) {
+		if ((logged & LIBPERF_EVENT_MASK(i)) == 0) {
+			continue;
+		}
+		char name[LIBPERF_BINLOG_NAME_SIZE] = {0};
+		strncpy(name, libperf_event_name((enum libperf_event)i), sizeof(name) - 1);
+		memcpy(log->buffer + log->used, name, sizeof(name));
+		log->used += sizeof(name);
+	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): binary log opened", __func__);
+	return log;
+}
+
+enum libperf_exit libperf_binlog_append(libperf_binlog *const log, const uint64_t tag, const uint64_t events, const uint64_t *const values)
+{
+	if (log == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (log->used + log->record_size > sizeof(log->buffer)) {
+		const enum libperf_exit rt = libperf_binlog_flush(log);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+	}
+
+	struct libperf_binlog_record *const record = (struct libperf_binlog_record *)(log->buffer + log->used); // buffer offsets stay multiples of 8 bytes
+	record->tag = tag;
+	record->timestamp = libperf_binlog_clock(CLOCK_MONOTONIC);
+	record->events = events & log->events;
+
+	uint64_t *const slots = (uint64_t *)(record + 1);
+	size_t slot = 0;
+	for (uint64_t remaining = log->events; remaining != 0; remaining &= remaining - 1) { // visit logged events lowest first
+		const unsigned event = (unsigned)__builtin_ctzll(remaining);
+		slots[slot++] = (record->events & LIBPERF_EVENT_MASK(event)) ? values[event] : 0;
+	}
+
+	log->used += log->record_size;
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_binlog_write(libperf_binlog *const log, libperf_tracker *const pd, const uint64_t tag)
+{
+	if (log == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	uint64_t values[LIBPERF_EVENT_SLOTS];
+	uint64_t events = 0;
+	const enum libperf_exit rt = libperf_read_enabled(pd, &events, values);
+	if (rt != LIBPERF_EXIT_SUCCESS) {
+		return rt;
+	}
+
+	return libperf_binlog_append(log, tag, events, values);
+}
+
+enum libperf_exit libperf_binlog_flush(libperf_binlog *const log)
+{
+	if (log == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (log->used == 0) {
+		return LIBPERF_EXIT_SUCCESS;
+	}
+
+	/* resume from where a previous flush was cut short, so no bytes are written out twice */
+	log->flushed += libperf_binlog_write_all(log->fd, log->buffer + log->flushed, log->used - log->flushed);
+	if (log->flushed < log->used) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to write out records", __func__);
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+	log->used = 0;
+	log->flushed = 0;
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+void libperf_binlog_close(libperf_binlog *const log)
+{
+	if (log == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return;
+	}
+
+	libperf_binlog_flush(log);
+	close(log->fd);
+	free(log);
+
+	libperf_diag(LOG_NOTICE, "libperf (in %s): binary log closed", __func__);
+}
@@ -0,0 +1,98 @@
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_binlog.h"
+
+#include "libperf.hpp"
+#include "libperf_binlog.hpp"
+
+/**
+ * @brief Definitions of libperf binary logging API in C++
+ * @author Salih MSA
+ */
+
+libperf::BinaryLog::BinaryLog(const char *const path, const std::uint64_t events) noexcept(false)
+{
+	this->_log = libperf_binlog_open(path, events) ;
+	if(this->_log == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::BinaryLog::BinaryLog(libperf::BinaryLog&& log) noexcept
+{
+	this->_log = log._log ;
+	log._log = nullptr ;
+}
+
+libperf::BinaryLog& libperf::BinaryLog::operator=(libperf::BinaryLog&& log) noexcept
+{
+	if(this != &log)
+	{
+		if(this->_log != nullptr)
+		{
+			libperf_binlog_close(this->_log) ;
+		}
+		this->_log = log._log ;
+		log._log = nullptr ;
+	}
+
+	return *this ;
+}
+
+void libperf::BinaryLog::write(const libperf::Tracker& tracker, const std::uint64_t tag) noexcept(false)
+{
+	const auto err = libperf_binlog_write(this->_log, tracker.handle(), tag) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+void libperf::BinaryLog::append(const std::uint64_t tag, const std::uint64_t events, const std::uint64_t *const values) noexcept(false)
+{
+	const auto err = libperf_binlog_append(this->_log, tag, events, values) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+void libperf::BinaryLog::flush() noexcept(false)
+{
+	const auto err = libperf_binlog_flush(this->_log) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+libperf::BinaryLog::~BinaryLog() noexcept
+{
+	if(this->_log != nullptr)
+	{
+		libperf_binlog_close(this->_log) ;
+	}
+}
@@ -0,0 +1,93 @@
+#ifndef LIBPERF_BINLOG_H
+#define LIBPERF_BINLOG_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf binary logging API
+ * @note A compact alternative to libperf_log(): rather than a formatted line per counter, each call appends one fixed-size record to a buffered file, which tools/libperf-decode converts to text or CSV afterwards
+ * @note Files consist of a struct libperf_binlog_header, the names of the events logged, then records. Integers are in the host's byte order
+ * @author Salih MSA
+ */
+
+struct libperf_binlog;
+typedef struct libperf_binlog libperf_binlog;
+
+#define LIBPERF_BINLOG_MAGIC "LPERFLOG" // first 8 bytes of every binary log
+#define LIBPERF_BINLOG_VERSION 1
+#define LIBPERF_BINLOG_NAME_SIZE 32 // size of each event name following the header, nul padded
+
+struct libperf_binlog_header { /* start of file */
+	char magic[8]; // LIBPERF_BINLOG_MAGIC, not nul terminated
+	uint32_t version; // LIBPERF_BINLOG_VERSION
+	uint32_t count; // number of events logged, ie of names following the header & values in each record
+	uint64_t events; // mask (see LIBPERF_EVENT_MASK) of events logged; values are stored in ascending order of enum libperf_event
+	uint64_t realtime; // CLOCK_REALTIME when log was opened, in nanoseconds
+	uint64_t monotonic; // CLOCK_MONOTONIC when log was opened, in nanoseconds; subtract from record timestamps & add realtime to get wall clock time
+};
+
+struct libperf_binlog_record { /* followed by count values */
+	uint64_t tag; // identifier supplied by the caller
+	uint64_t timestamp; // CLOCK_MONOTONIC, in nanoseconds
+	uint64_t events; // mask of events which were read; the values of the rest are 0
+};
+
+/**
+ * @brief libperf_binlog_open - function creates (or truncates) a binary log
+ * @param const char *const path - path of file to write to
+ * @param const uint64_t events - mask (see LIBPERF_EVENT_MASK) of counters to log; special library counters don't apply
+ * @return libperf_binlog* - handle for use in future library calls
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_binlog *libperf_binlog_open(const char *const path, const uint64_t events);
+
+/**
+ * @brief libperf_binlog_write - function reads the enabled counters of a tracker and appends them as a record
+ * @note The record is buffered in memory; it reaches the file when the buffer fills, or upon libperf_binlog_flush() / libperf_binlog_close()
+ * @param libperf_binlog *const log - handle obtained from libperf_binlog_open()
+ * @param libperf_tracker *const pd - tracker to read (see libperf_read_enabled())
+ * @param const uint64_t tag - a unique identifier for the record (e.g. a request ID)
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_binlog_write(libperf_binlog *const log, libperf_tracker *const pd, const uint64_t tag);
+
+/**
+ * @brief libperf_binlog_append - function appends a record of values obtained by other means (e.g. libperf_cpu_read_counter())
+ * @param libperf_binlog *const log - handle obtained from libperf_binlog_open()
+ * @param const uint64_t tag - a unique identifier for the record
+ * @param const uint64_t events - mask of which values are present
+ * @param const uint64_t *const values - array indexed by enum libperf_event (ie of LIBPERF_EVENT_SLOTS entries)
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_binlog_append(libperf_binlog *const log, const uint64_t tag, const uint64_t events, const uint64_t *const values);
+
+/**
+ * @brief libperf_binlog_flush - function writes out buffered records
+ * @note Should writing fail part way through, calling again resumes after what was written out, so nothing is duplicated
+ * @param libperf_binlog *const log - handle obtained from libperf_binlog_open()
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_binlog_flush(libperf_binlog *const log);
+
+/**
+ * @brief libperf_binlog_close - function flushes and closes a binary log
+ * @param libperf_binlog *const log - handle obtained from libperf_binlog_open()
+ */
+void libperf_binlog_close(libperf_binlog *const log);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_BINLOG_H
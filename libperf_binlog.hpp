@@ -0,0 +1,91 @@
+#ifndef LIBPERF_BINLOG_HPP
+#define LIBPERF_BINLOG_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "libperf.hpp"
+#include "libperf_binlog.h"
+
+/**
+ * @brief Declarations of libperf binary logging API for C++
+ * @note Access to binary logs in C++ in via an RAII-complaint container
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	class BinaryLog {
+		private:
+			libperf_binlog* _log ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief BinaryLog (constructor) - creates (or truncates) a binary log
+			 * @note Stub to libperf_binlog_open()
+			 * @param const char *const path - path of file to write to
+			 * @param const std::uint64_t events - mask (see LIBPERF_EVENT_MASK) of counters to log
+			 * @throws std::system_error - thrown if the log couldn't be opened, with the errno which caused it
+			 */
+			explicit BinaryLog(const char *const path, const std::uint64_t events) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as the file has one writer
+			 */
+			BinaryLog(const BinaryLog& log) noexcept(false) = delete ;
+			BinaryLog& operator=(const BinaryLog& log) noexcept(false) = delete ;
+
+			/**
+			 * @brief BinaryLog (move constructor) - acquire existing log
+			 * @param BinaryLog&& log - log to acquire
+			 */
+			explicit BinaryLog(BinaryLog&& log) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing log, closing the one held
+			 * @param BinaryLog&& log - log to acquire
+			 * @return BinaryLog& - object which acquired
+			 */
+			BinaryLog& operator=(BinaryLog&& log) noexcept ;
+
+			/**
+			 * @brief write - method reads the enabled counters of a tracker and appends them as a record
+			 * @note Stub to libperf_binlog_write()
+			 * @param const Tracker& tracker - tracker to read
+			 * @param const std::uint64_t tag - a unique identifier for the record
+			 * @throws std::system_error - thrown if we can't read the tracker or write out records
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			void write(const Tracker& tracker, const std::uint64_t tag) noexcept(false) ;
+
+			/**
+			 * @brief append - method appends a record of values obtained by other means
+			 * @note Stub to libperf_binlog_append()
+			 * @param const std::uint64_t tag - a unique identifier for the record
+			 * @param const std::uint64_t events - mask of which values are present
+			 * @param const std::uint64_t *const values - array indexed by libperf_event (ie of LIBPERF_EVENT_SLOTS entries)
+			 * @throws std::system_error - thrown if we can't write out records
+			 * @note Category of std::system_error will be std::generic_category
+			 */
+			void append(const std::uint64_t tag, const std::uint64_t events, const std::uint64_t *const values) noexcept(false) ;
+
+			/**
+			 * @brief flush - method writes out buffered records
+			 * @note Stub to libperf_binlog_flush()
+			 * @throws std::system_error - thrown if we can't write out records
+			 * @note Category of std::system_error will be std::generic_category
+			 */
+			void flush() noexcept(false) ;
+
+			/**
+			 * @brief ~BinaryLog - flushes and closes the log
+			 * @note Stub to libperf_binlog_close()
+			 */
+			~BinaryLog() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_BINLOG_HPP
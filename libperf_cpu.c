@@ -0,0 +1,305 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_cpu.h"
+
+/**
+ * @brief Definitions of libperf per-CPU API and inner functionality
+ * @author Salih MSA
+ */
+
+struct libperf_cpu_tracker { /* lib struct */
+	size_t count; // number of CPUs spanned
+	int *cpus; // CPU IDs
+	int *packages; // physical package of each CPU (or -1 if unknown)
+	libperf_tracker **trackers; // tracker of each CPU
+	int cgroup; // fd of cgroup directory tracked (or -1 if tracking a process)
+};
+
+/**
+ * @brief libperf_read_package - reads which physical package a CPU belongs to
+ * @param const int cpu - CPU ID
+ * @return int - package ID, or -1 if unknown
+ */
+static int libperf_read_package(const int cpu)
+{
+	char path[128];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+
+	FILE *const file = fopen(path, "r");
+	if (file == NULL) {
+		return -1;
+	}
+
+	int package;
+	if (fscanf(file, "%d", &package) != 1) {
+		package = -1;
+	}
+	fclose(file);
+
+	return package;
+}
+
+enum libperf_exit libperf_online_cpus(int *const cpus, const size_t max, size_t *const count)
+{
+	FILE *const file = fopen("/sys/devices/system/cpu/online", "r");
+	if (file == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to open list of online CPUs", __func__);
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	/* list is comma separated ranges, e.g. 0-3,5,7-9 */
+	*count = 0;
+	int first;
+	while (fscanf(file, "%d", &first) == 1) {
+		int last = first;
+		int separator = fgetc(file);
+		if (separator == '-') {
+			if (fscanf(file, "%d", &last) != 1) {
+				break;
+			}
+			separator = fgetc(file);
+		}
+
+		for (int cpu = first; cpu <= last; ++cpu) {
+			if (*count == max) {
+				fclose(file);
+				libperf_diag(LOG_ERR, "libperf (in %s): more than %lu CPUs online", __func__, max);
+				errno = ENOBUFS;
+				return LIBPERF_EXIT_SYSTEM_ERROR;
+			}
+			cpus[(*count)++] = cpu;
+		}
+
+		if (separator != ',') {
+			break;
+		}
+	}
+	fclose(file);
+
+	if (*count == 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to parse list of online CPUs", __func__);
+		errno = EINVAL;
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+/**
+ * @brief libperf_cpu_release - shuts down whichever per-CPU trackers were initialised, then releases the handle
+ * @note errno is preserved, so callers can bail out of initialisation with it intact
+ * @param libperf_cpu_tracker *const ct - handle to release
+ */
+static void libperf_cpu_release(libperf_cpu_tracker *const ct)
+{
+	const int err = errno;
+
+	if (ct->trackers != NULL) {
+		for (size_t i = 0; i < ct->count; ++i) {
+			if (ct->trackers[i] != NULL) {
+				libperf_fini(ct->trackers[i]);
+			}
+		}
+	}
+
+	if (ct->cgroup >= 0) {
+		close(ct->cgroup);
+	}
+
+	free(ct->trackers);
+	free(ct->packages);
+	free(ct->cpus);
+	free(ct);
+
+	errno = err;
+}
+
+/**
+ * @brief libperf_cpu_spawn - initialises a tracker on every online CPU
+ * @param const pid_t id - process ID, thread ID, or cgroup's fd (see flags)
+ * @param const uint64_t events - mask of counters to open on each CPU
+ * @param const unsigned int flags - flags of libperf_init_selective()
+ * @param const int cgroup - fd of cgroup directory handed over to the tracker (or -1)
+ * @param const char *const caller - name of API function, for logging
+ * @return libperf_cpu_tracker* - handle, or NULL with errno set if any CPU failed (cgroup is closed regardless)
+ */
+static libperf_cpu_tracker *libperf_cpu_spawn(const pid_t id, const uint64_t events, const unsigned int flags, const int cgroup, const char *const caller)
+{
+	libperf_cpu_tracker *ct = calloc(1, sizeof(libperf_cpu_tracker));
+	if (ct == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", caller);
+		if (cgroup >= 0) {
+			close(cgroup);
+		}
+		return NULL;
+	}
+	ct->cgroup = cgroup;
+
+	int online[LIBPERF_CPU_MAX];
+	if (libperf_online_cpus(online, LIBPERF_CPU_MAX, &ct->count) != LIBPERF_EXIT_SUCCESS) {
+		libperf_cpu_release(ct);
+		return NULL;
+	}
+
+	ct->cpus = malloc(ct->count * sizeof(int));
+	ct->packages = malloc(ct->count * sizeof(int));
+	ct->trackers = calloc(ct->count, sizeof(libperf_tracker *));
+	if (ct->cpus == NULL || ct->packages == NULL || ct->trackers == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for per-CPU trackers", caller);
+		libperf_cpu_release(ct);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < ct->count; ++i) {
+		ct->cpus[i] = online[i];
+		ct->packages[i] = libperf_read_package(online[i]);
+		ct->trackers[i] = libperf_init_selective(id, online[i], events, flags);
+		if (ct->trackers[i] == NULL) {
+			libperf_diag(LOG_ERR, "libperf (in %s): unable to initialise tracker on CPU %d", caller, online[i]);
+			libperf_cpu_release(ct);
+			return NULL;
+		}
+	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): tracking across %lu CPUs", caller, ct->count);
+	return ct;
+}
+
+libperf_cpu_tracker *libperf_cpu_init(const pid_t id, const uint64_t events)
+{
+	return libperf_cpu_spawn(id, events, LIBPERF_INIT_DEFAULT, -1, __func__);
+}
+
+libperf_cpu_tracker *libperf_cpu_init_cgroup(const char *const path, const uint64_t events)
+{
+	if (path == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): no cgroup supplied", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	char full[4096];
+	if (snprintf(full, sizeof(full), "%s%s", path[0] == '/' ? "" : "/sys/fs/cgroup/", path) >= (int)sizeof(full)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): cgroup path too long", __func__);
+		errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	const int cgroup = open(full, O_RDONLY | O_DIRECTORY | O_CLOEXEC); // perf_event_open takes the directory's fd in place of a pid
+	if (cgroup < 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to open cgroup '%s'", __func__, full);
+		return NULL;
+	}
+
+	return libperf_cpu_spawn(cgroup, events, LIBPERF_INIT_CGROUP, cgroup, __func__);
+}
+
+size_t libperf_cpu_count(const libperf_cpu_tracker *const ct)
+{
+	if (ct == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return ct->count;
+}
+
+int libperf_cpu_id(const libperf_cpu_tracker *const ct, const size_t index)
+{
+	if (ct == NULL || index >= ct->count) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle or CPU index", __func__);
+		return -1;
+	}
+
+	return ct->cpus[index];
+}
+
+int libperf_cpu_package(const libperf_cpu_tracker *const ct, const size_t index)
+{
+	if (ct == NULL || index >= ct->count) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle or CPU index", __func__);
+		return -1;
+	}
+
+	return ct->packages[index];
+}
+
+enum libperf_exit libperf_cpu_toggle_counter(libperf_cpu_tracker *const ct, const enum libperf_event counter, const enum libperf_event_toggle toggle_type)
+{
+	if (ct == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (toggle_type != LIBPERF_EVENT_TOGGLE_ON && toggle_type != LIBPERF_EVENT_TOGGLE_OFF && toggle_type != LIBPERF_EVENT_TOGGLE_RESET) { // others take arguments which make little sense to fan out
+		libperf_diag(LOG_ERR, "libperf (in %s): unsupported configuration supplied", __func__);
+		return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+
+	for (size_t i = 0; i < ct->count; ++i) {
+		const enum libperf_exit rt = libperf_toggle_counter(ct->trackers[i], counter, toggle_type);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_cpu_read_counter(libperf_cpu_tracker *const ct, const enum libperf_event counter, struct libperf_counter_value *const per_cpu, struct libperf_counter_value *const total)
+{
+	if (ct == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	struct libperf_counter_value sum = { 0, 0, 0, 0 };
+
+	for (size_t i = 0; i < ct->count; ++i) {
+		struct libperf_counter_value value;
+		const enum libperf_exit rt = libperf_read_counter_scaled(ct->trackers[i], counter, &value);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+
+		if (per_cpu != NULL) {
+			per_cpu[i] = value;
+		}
+
+		/* each CPU is multiplexed independently, so scale per CPU then sum */
+		sum.raw += value.raw;
+		sum.time_enabled += value.time_enabled;
+		sum.time_running += value.time_running;
+		sum.scaled += value.scaled;
+	}
+
+	if (total != NULL) {
+		*total = sum;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+void libperf_cpu_fini(libperf_cpu_tracker *const ct)
+{
+	if (ct == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return;
+	}
+
+	libperf_cpu_release(ct);
+
+	libperf_diag(LOG_NOTICE, "libperf (in %s): per-CPU tracker shut down", __func__);
+}
@@ -0,0 +1,111 @@
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_cpu.h"
+
+#include "libperf.hpp"
+#include "libperf_cpu.hpp"
+
+/**
+ * @brief Definitions of libperf per-CPU API in C++
+ * @author Salih MSA
+ */
+
+libperf::CpuTracker::CpuTracker(const pid_t id, const std::uint64_t events) noexcept(false)
+{
+	this->_tracker = libperf_cpu_init(id, events) ;
+	if(this->_tracker == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::CpuTracker::CpuTracker(const char *const cgroup, const std::uint64_t events) noexcept(false)
+{
+	this->_tracker = libperf_cpu_init_cgroup(cgroup, events) ;
+	if(this->_tracker == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::CpuTracker::CpuTracker(libperf::CpuTracker&& tracker) noexcept
+{
+	this->_tracker = tracker._tracker ;
+	tracker._tracker = nullptr ;
+}
+
+libperf::CpuTracker& libperf::CpuTracker::operator=(libperf::CpuTracker&& tracker) noexcept
+{
+	if(this != &tracker)
+	{
+		if(this->_tracker != nullptr)
+		{
+			libperf_cpu_fini(this->_tracker) ;
+		}
+		this->_tracker = tracker._tracker ;
+		tracker._tracker = nullptr ;
+	}
+
+	return *this ;
+}
+
+std::size_t libperf::CpuTracker::size() const noexcept
+{
+	return libperf_cpu_count(this->_tracker) ;
+}
+
+int libperf::CpuTracker::cpu(const std::size_t index) const noexcept
+{
+	return libperf_cpu_id(this->_tracker, index) ;
+}
+
+int libperf::CpuTracker::package(const std::size_t index) const noexcept
+{
+	return libperf_cpu_package(this->_tracker, index) ;
+}
+
+void libperf::CpuTracker::toggle_counter(const libperf_event counter, const libperf_event_toggle toggle_type) noexcept(false)
+{
+	const auto err = libperf_cpu_toggle_counter(this->_tracker, counter, toggle_type) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+libperf_counter_value libperf::CpuTracker::read_counter(const libperf_event counter, libperf_counter_value *const per_cpu) const noexcept(false)
+{
+	libperf_counter_value total ;
+
+	const auto err = libperf_cpu_read_counter(this->_tracker, counter, per_cpu, &total) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+
+	return total ;
+}
+
+libperf::CpuTracker::~CpuTracker() noexcept
+{
+	if(this->_tracker != nullptr)
+	{
+		libperf_cpu_fini(this->_tracker) ;
+	}
+}
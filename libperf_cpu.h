@@ -0,0 +1,110 @@
+#ifndef LIBPERF_CPU_H
+#define LIBPERF_CPU_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf per-CPU API
+ * @note Tracking with an id of -1 requires a concrete CPU, so a CPU tracker fans out one libperf_tracker per online CPU and gathers their values back up
+ * @author Salih MSA
+ */
+
+#define LIBPERF_CPU_MAX 4096 // most CPUs a tracker can fan out across
+
+struct libperf_cpu_tracker;
+typedef struct libperf_cpu_tracker libperf_cpu_tracker;
+
+/**
+ * @brief libperf_online_cpus - function lists CPUs currently online, as per /sys/devices/system/cpu/online
+ * @param int *const cpus - array to write CPU IDs out to, in ascending order
+ * @param const size_t max - capacity of array
+ * @param size_t *const count - number of CPUs written out
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_SYSTEM_ERROR if the list couldn't be read, or more CPUs are online than fit in the array
+ */
+enum libperf_exit libperf_online_cpus(int *const cpus, const size_t max, size_t *const count);
+
+/**
+ * @brief libperf_cpu_init - function initialises a tracker on every online CPU
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @note Set -1 for system wide readings, which is what this is mostly for
+ * @param const uint64_t events - mask of counters to open on each CPU, built with LIBPERF_EVENT_MASK()
+ * @return libperf_cpu_tracker* - handle for use in future library calls
+ * @note return NULL if failure occurs on any CPU, with errno set to the cause
+ */
+libperf_cpu_tracker *libperf_cpu_init(const pid_t id, const uint64_t events);
+
+/**
+ * @brief libperf_cpu_init_cgroup - function initialises a tracker on every online CPU, counting every task of a cgroup
+ * @note Counters are opened with PERF_FLAG_PID_CGROUP (see LIBPERF_INIT_CGROUP), so e.g. a container's cache & TLB behaviour is tracked without attaching to each of its processes. libperf_cpu_read_counter() sums the CPUs
+ * @param const char *const path - cgroup v2 directory, either absolute or relative to /sys/fs/cgroup (e.g. system.slice/docker-<id>.scope)
+ * @param const uint64_t events - mask of counters to open on each CPU, built with LIBPERF_EVENT_MASK()
+ * @return libperf_cpu_tracker* - handle for use in future library calls
+ * @note return NULL if failure occurs on any CPU, with errno set to the cause
+ */
+libperf_cpu_tracker *libperf_cpu_init_cgroup(const char *const path, const uint64_t events);
+
+/**
+ * @brief libperf_cpu_count - function obtains how many CPUs a tracker spans
+ * @param const libperf_cpu_tracker *const ct - handle obtained from libperf_cpu_init()
+ * @return size_t - number of CPUs, ie size of per-CPU arrays
+ */
+size_t libperf_cpu_count(const libperf_cpu_tracker *const ct);
+
+/**
+ * @brief libperf_cpu_id - function obtains the ID of a CPU spanned by a tracker
+ * @param const libperf_cpu_tracker *const ct - handle obtained from libperf_cpu_init()
+ * @param const size_t index - index into per-CPU arrays
+ * @return int - CPU ID, or -1 if index is out of range
+ */
+int libperf_cpu_id(const libperf_cpu_tracker *const ct, const size_t index);
+
+/**
+ * @brief libperf_cpu_package - function obtains the physical package (socket) of a CPU spanned by a tracker
+ * @param const libperf_cpu_tracker *const ct - handle obtained from libperf_cpu_init()
+ * @param const size_t index - index into per-CPU arrays
+ * @return int - package ID, or -1 if unknown or index is out of range
+ */
+int libperf_cpu_package(const libperf_cpu_tracker *const ct, const size_t index);
+
+/**
+ * @brief libperf_cpu_toggle_counter - function manipulates a counter on every CPU
+ * @param libperf_cpu_tracker *const ct - handle obtained from libperf_cpu_init()
+ * @param const enum libperf_event counter - counter type
+ * @param const enum libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); stops at the first CPU which fails
+ */
+enum libperf_exit libperf_cpu_toggle_counter(libperf_cpu_tracker *const ct, const enum libperf_event counter, const enum libperf_event_toggle toggle_type);
+
+/**
+ * @brief libperf_cpu_read_counter - function reads a counter on every CPU
+ * @pre libperf_cpu_toggle_counter(..., counter, LIBPERF_EVENT_TOGGLE_ON) - enable counter
+ * @param libperf_cpu_tracker *const ct - handle obtained from libperf_cpu_init()
+ * @param const enum libperf_event counter - counter type
+ * @param struct libperf_counter_value *const per_cpu - array of libperf_cpu_count() values to write each CPU's value out to (may be NULL)
+ * @param struct libperf_counter_value *const total - value to write sum across CPUs out to (may be NULL)
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_cpu_read_counter(libperf_cpu_tracker *const ct, const enum libperf_event counter, struct libperf_counter_value *const per_cpu, struct libperf_counter_value *const total);
+
+/**
+ * @brief libperf_cpu_fini - function shuts down the tracker on every CPU
+ * @param libperf_cpu_tracker *const ct - handle obtained from libperf_cpu_init()
+ */
+void libperf_cpu_fini(libperf_cpu_tracker *const ct);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_CPU_H
@@ -0,0 +1,116 @@
+#ifndef LIBPERF_CPU_HPP
+#define LIBPERF_CPU_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "libperf.hpp"
+#include "libperf_cpu.h"
+
+/**
+ * @brief Declarations of libperf per-CPU API for C++
+ * @note Access to per-CPU trackers in C++ in via an RAII-complaint container
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	class CpuTracker {
+		private:
+			libperf_cpu_tracker* _tracker ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief CpuTracker (constructor) - initialises a tracker on every online CPU
+			 * @note Stub to libperf_cpu_init()
+			 * @param const pid_t id - process ID *or* thread ID to monitor
+			 * @note Set -1 for system wide readings
+			 * @param const std::uint64_t events - mask of counters to open on each CPU, built with LIBPERF_EVENT_MASK()
+			 * @throws std::system_error - thrown if any CPU's tracker couldn't be initialised, with the errno which caused it
+			 */
+			explicit CpuTracker(const pid_t id, const std::uint64_t events) noexcept(false) ;
+
+			/**
+			 * @brief CpuTracker (constructor) - initialises a tracker on every online CPU, counting every task of a cgroup
+			 * @note Stub to libperf_cpu_init_cgroup()
+			 * @param const char *const cgroup - cgroup v2 directory, either absolute or relative to /sys/fs/cgroup
+			 * @param const std::uint64_t events - mask of counters to open on each CPU, built with LIBPERF_EVENT_MASK()
+			 * @throws std::system_error - thrown if the cgroup couldn't be opened, or any CPU's tracker initialised, with the errno which caused it
+			 */
+			explicit CpuTracker(const char *const cgroup, const std::uint64_t events) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as with libperf::Tracker
+			 */
+			CpuTracker(const CpuTracker& tracker) noexcept(false) = delete ;
+			CpuTracker& operator=(const CpuTracker& tracker) noexcept(false) = delete ;
+
+			/**
+			 * @brief CpuTracker (move constructor) - acquire existing per-CPU tracker
+			 * @param CpuTracker&& tracker - tracker to acquire
+			 */
+			explicit CpuTracker(CpuTracker&& tracker) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing per-CPU tracker, shutting down the one held
+			 * @param CpuTracker&& tracker - tracker to acquire
+			 * @return CpuTracker& - object which acquired
+			 */
+			CpuTracker& operator=(CpuTracker&& tracker) noexcept ;
+
+			/**
+			 * @brief size - method obtains how many CPUs are spanned
+			 * @note Stub to libperf_cpu_count()
+			 * @return std::size_t - number of CPUs, ie size of per-CPU arrays
+			 */
+			std::size_t size() const noexcept ;
+
+			/**
+			 * @brief cpu - method obtains the ID of a spanned CPU
+			 * @note Stub to libperf_cpu_id()
+			 * @param const std::size_t index - index into per-CPU arrays
+			 * @return int - CPU ID, or -1 if index is out of range
+			 */
+			int cpu(const std::size_t index) const noexcept ;
+
+			/**
+			 * @brief package - method obtains the physical package (socket) of a spanned CPU
+			 * @note Stub to libperf_cpu_package()
+			 * @param const std::size_t index - index into per-CPU arrays
+			 * @return int - package ID, or -1 if unknown or index is out of range
+			 */
+			int package(const std::size_t index) const noexcept ;
+
+			/**
+			 * @brief toggle_counter - method manipulates a counter on every CPU
+			 * @note Stub to libperf_cpu_toggle_counter()
+			 * @param const libperf_event counter - counter type
+			 * @param const libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+			 * @throws std::system_error - thrown if we can't manipulate counter
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			void toggle_counter(const libperf_event counter, const libperf_event_toggle toggle_type) noexcept(false) ;
+
+			/**
+			 * @brief read_counter - method reads a counter on every CPU
+			 * @note Stub to libperf_cpu_read_counter()
+			 * @param const libperf_event counter - counter type
+			 * @param libperf_counter_value *const per_cpu - array of size() values to write each CPU's value out to (may be nullptr)
+			 * @return libperf_counter_value - sum across CPUs
+			 * @throws std::system_error - thrown if we can't read value
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			libperf_counter_value read_counter(const libperf_event counter, libperf_counter_value *const per_cpu = nullptr) const noexcept(false) ;
+
+			/**
+			 * @brief ~CpuTracker - shuts down the tracker on every CPU
+			 * @note Stub to libperf_cpu_fini()
+			 */
+			~CpuTracker() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_CPU_HPP
@@ -0,0 +1,108 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <syslog.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+
+/**
+ * @brief Definitions of libperf's diagnostics channel
+ * @author Salih MSA
+ */
+
+#define LIBPERF_DIAG_MESSAGE 256 // longest message passed to the sink, including nul terminator
+#define LIBPERF_DIAG_COUNT_BITS 24 // low bits of rate limiting state holding messages sent this second; high bits hold the second
+
+static void libperf_diag_syslog(const int level, const char *const message, void *const context)
+{
+	(void)context;
+	syslog(level, "%s", message);
+}
+
+static libperf_diag_sink diag_sink = libperf_diag_syslog; // where messages go, NULL to discard
+static void *diag_context = NULL;
+static int diag_level = LIBPERF_DIAG_LEVEL; // runtime filter, on top of compile time one
+static uint64_t diag_state = 0; // second & messages sent within it, updated together with one compare-and-swap
+static uint64_t diag_suppressed = 0; // messages dropped by rate limiting, not yet reported
+
+void libperf_set_diag_sink(const libperf_diag_sink sink, void *const context)
+{
+	__atomic_store_n(&diag_context, context, __ATOMIC_RELAXED);
+	__atomic_store_n(&diag_sink, sink, __ATOMIC_RELEASE); // release so a sink is never seen before its context
+}
+
+void libperf_set_diag_level(const int level)
+{
+	__atomic_store_n(&diag_level, level, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief libperf_diag_admit - rate limits messages, allowing LIBPERF_DIAG_RATE per second
+ * @param uint64_t *const suppressed - written out with messages suppressed during previous seconds, to report, if this message starts a new second
+ * @return bool - whether message may be passed on
+ */
+static bool libperf_diag_admit(uint64_t *const suppressed)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &now); // served from the vDSO, so no syscall
+	const uint64_t second = (uint64_t)now.tv_sec;
+
+	*suppressed = 0;
+	uint64_t state = __atomic_load_n(&diag_state, __ATOMIC_RELAXED);
+	for (;;) {
+		uint64_t next;
+		if ((state >> LIBPERF_DIAG_COUNT_BITS) != second) { // first message this second
+			next = (second << LIBPERF_DIAG_COUNT_BITS) | 1;
+		} else if ((state & ((UINT64_C(1) << LIBPERF_DIAG_COUNT_BITS) - 1)) >= LIBPERF_DIAG_RATE) {
+			__atomic_fetch_add(&diag_suppressed, 1, __ATOMIC_RELAXED);
+			return false;
+		} else {
+			next = state + 1;
+		}
+
+		if (__atomic_compare_exchange_n(&diag_state, &state, next, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			if ((next & ((UINT64_C(1) << LIBPERF_DIAG_COUNT_BITS) - 1)) == 1) {
+				*suppressed = __atomic_exchange_n(&diag_suppressed, 0, __ATOMIC_RELAXED);
+			}
+			return true;
+		}
+	}
+}
+
+void libperf_diag_emit(const int level, const char *const format, ...)
+{
+	if (level > __atomic_load_n(&diag_level, __ATOMIC_RELAXED)) {
+		return;
+	}
+
+	const libperf_diag_sink sink = __atomic_load_n(&diag_sink, __ATOMIC_ACQUIRE);
+	if (sink == NULL) {
+		return;
+	}
+	void *const context = __atomic_load_n(&diag_context, __ATOMIC_RELAXED);
+
+	uint64_t suppressed;
+	if (!libperf_diag_admit(&suppressed)) {
+		return;
+	}
+
+	char message[LIBPERF_DIAG_MESSAGE];
+	if (suppressed > 0) {
+		snprintf(message, sizeof(message), "libperf: %lu messages suppressed", suppressed);
+		sink(LOG_WARNING, message, context);
+	}
+
+	va_list args;
+	va_start(args, format);
+	vsnprintf(message, sizeof(message), format, args);
+	va_end(args);
+
+	sink(level, message, context);
+}
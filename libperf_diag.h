@@ -0,0 +1,41 @@
+#ifndef LIBPERF_DIAG_H
+#define LIBPERF_DIAG_H
+#pragma once
+
+#include <syslog.h> // levels are syslog's
+
+/**
+ * @brief Declarations of libperf's internal diagnostics channel
+ * @note Internal to libperf's translation units; applications configure diagnostics through libperf_set_diag_sink() & libperf_set_diag_level() (see libperf.h)
+ * @author Salih MSA
+ */
+
+#ifndef LIBPERF_DIAG_LEVEL
+#define LIBPERF_DIAG_LEVEL LOG_WARNING // messages less severe than this are compiled out; build with -DLIBPERF_DIAG_LEVEL=LOG_DEBUG to see success messages too
+#endif
+
+#ifndef LIBPERF_DIAG_RATE
+#define LIBPERF_DIAG_RATE 16 // messages passed on to the sink per second, beyond which they're counted & suppressed
+#endif
+
+/**
+ * @brief libperf_diag - reports a diagnostic message, with printf() style formatting
+ * @note Expands to nothing when level is less severe than LIBPERF_DIAG_LEVEL, so success paths cost nothing by default
+ * @param level - syslog level (e.g. LOG_ERR)
+ */
+#define libperf_diag(level, ...) do { \
+		if ((level) <= LIBPERF_DIAG_LEVEL) { \
+			libperf_diag_emit((level), __VA_ARGS__); \
+		} \
+	} while (0)
+
+/**
+ * @brief libperf_diag_emit - filters, rate limits, formats and passes on a message to the sink
+ * @note Lock-free, so can be called from any thread
+ * @param const int level - syslog level
+ * @param const char *const format - printf() style format string
+ * @param ... - format arguments
+ */
+void libperf_diag_emit(const int level, const char *const format, ...) __attribute__((format(printf, 2, 3)));
+
+#endif // LIBPERF_DIAG_H
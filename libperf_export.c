@@ -0,0 +1,636 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/un.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_export.h"
+
+/**
+ * @brief Definitions of libperf metrics exporter API and inner functionality
+ * @author Salih MSA
+ */
+
+#define LIBPERF_EXPORT_REQUEST 4096 // longest HTTP request head read; anything longer is refused
+#define LIBPERF_EXPORT_TIMEOUT 1 // seconds a client may take to send its request or receive the response, so a stalled one can't hold up the thread
+
+struct libperf_export_ratio { /* metric derived from a pair of events */
+	const char *name;
+	const char *help;
+	enum libperf_event numerator;
+	enum libperf_event denominator;
+};
+
+static const struct libperf_export_ratio libperf_export_ratios[] = {
+	{ "libperf_ipc", "Instructions retired per cycle since the previous scrape.", LIBPERF_EVENT_HW_INSTRUCTIONS, LIBPERF_EVENT_HW_CPU_CYCLES },
+	{ "libperf_cache_miss_ratio", "Cache misses per cache reference since the previous scrape.", LIBPERF_EVENT_HW_CACHE_MISSES, LIBPERF_EVENT_HW_CACHE_REFERENCES },
+	{ "libperf_llc_load_miss_ratio", "Last level cache load misses per load since the previous scrape.", LIBPERF_EVENT_HW_CACHE_LL_LOADS_MISSES, LIBPERF_EVENT_HW_CACHE_LL_LOADS },
+	{ "libperf_dtlb_load_miss_ratio", "Data TLB load misses per load since the previous scrape.", LIBPERF_EVENT_HW_CACHE_DTLB_LOADS_MISSES, LIBPERF_EVENT_HW_CACHE_DTLB_LOADS },
+	{ "libperf_branch_miss_ratio", "Branch mispredictions per branch since the previous scrape.", LIBPERF_EVENT_HW_BRANCH_MISSES, LIBPERF_EVENT_HW_BRANCH_INSTRUCTIONS }
+};
+
+struct libperf_exporter { /* lib struct */
+	int listener; // listening socket
+	int wake[2]; // pipe written to, to ask exporter thread to exit
+	uint16_t port; // TCP port (or 0 if a Unix domain socket)
+	char path[sizeof(((struct sockaddr_un *)NULL)->sun_path)]; // path of Unix domain socket (or empty if TCP)
+	pthread_t thread;
+	uint64_t scrapes; // scrapes served
+
+	pthread_mutex_t lock; // guards registry, held whilst a scrape reads trackers & by (un)registration - never whilst talking to a client
+	size_t count; // number of trackers registered
+	libperf_tracker *trackers[LIBPERF_EXPORT_MAX];
+	char names[LIBPERF_EXPORT_MAX][LIBPERF_EXPORT_NAME];
+	struct libperf_snapshot *current; // snapshot of each tracker taken by this scrape
+	struct libperf_snapshot *previous; // snapshot of each tracker taken by the previous scrape (count of 0 if none)
+	bool *read; // whether each tracker was read by this scrape
+
+	char *body; // response body, reused between scrapes; only touched by exporter thread, so needs no lock
+	size_t body_size; // capacity of body
+	size_t body_length; // length of body written so far
+	bool body_failed; // whether body couldn't grow, so is incomplete
+};
+
+/**
+ * @brief libperf_export_append - appends formatted text to the response body, growing it as needed
+ * @param libperf_exporter *const exporter - exporter
+ * @param const char *const format - printf() format
+ */
+static void libperf_export_append(libperf_exporter *const exporter, const char *const format, ...)
+{
+	if (exporter->body_failed) {
+		return;
+	}
+
+	for (;;) {
+		va_list args;
+		va_start(args, format);
+		const int written = vsnprintf(exporter->body + exporter->body_length, exporter->body_size - exporter->body_length, format, args);
+		va_end(args);
+
+		if (written < 0) {
+			exporter->body_failed = true;
+			return;
+		} else if ((size_t)written < exporter->body_size - exporter->body_length) {
+			exporter->body_length += (size_t)written;
+			return;
+		}
+
+		const size_t size = exporter->body_size * 2 > exporter->body_length + (size_t)written + 1 ? exporter->body_size * 2 : exporter->body_length + (size_t)written + 1;
+		char *const body = realloc(exporter->body, size);
+		if (body == NULL) {
+			libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for response", __func__);
+			exporter->body_failed = true;
+			return;
+		}
+		exporter->body = body;
+		exporter->body_size = size;
+	}
+}
+
+/**
+ * @brief libperf_export_labels - appends the label set of a sample, escaping values as OpenMetrics requires
+ * @param libperf_exporter *const exporter - exporter
+ * @param const char *const tracker - tracker name
+ * @param const char *const event - event name (or NULL if the sample isn't of an event)
+ */
+static void libperf_export_labels(libperf_exporter *const exporter, const char *const tracker, const char *const event)
+{
+	libperf_export_append(exporter, "{tracker=\"");
+	for (const char *c = tracker; *c != '\0'; ++c) {
+		if (*c == '\\' || *c == '"') {
+			libperf_export_append(exporter, "\\%c", *c);
+		} else if (*c == '\n') {
+			libperf_export_append(exporter, "\\n");
+		} else {
+			libperf_export_append(exporter, "%c", *c);
+		}
+	}
+	libperf_export_append(exporter, "\"");
+
+	if (event != NULL) { // event names are plain identifiers, needing no escaping
+		libperf_export_append(exporter, ",event=\"%s\"", event);
+	}
+	libperf_export_append(exporter, "}");
+}
+
+/**
+ * @brief libperf_export_interval - estimates how far an event advanced since the previous scrape, accounting for multiplexing
+ * @param const struct libperf_snapshot *const current - snapshot of this scrape
+ * @param const struct libperf_snapshot *const previous - snapshot of previous scrape; if empty or of other events, the event's total is taken
+ * @param const enum libperf_event event - event
+ * @param double *const value - estimate to write out to
+ * @return bool - whether the event is counted by the tracker
+ */
+static bool libperf_export_interval(const struct libperf_snapshot *const current, const struct libperf_snapshot *const previous, const enum libperf_event event, double *const value)
+{
+	const int index = libperf_snapshot_index(current, event);
+	if (index < 0) {
+		return false;
+	}
+
+	uint64_t raw = current->values[index];
+	uint64_t enabled = current->time_enabled[index];
+	uint64_t running = current->time_running[index];
+	if (previous->count != 0 && previous->mask == current->mask) {
+		raw -= previous->values[index];
+		enabled -= previous->time_enabled[index];
+		running -= previous->time_running[index];
+	}
+
+	if (running == 0) { // as libperf_snapshot_scale()
+		*value = 0.0;
+	} else if (running >= enabled) {
+		*value = (double)raw;
+	} else {
+		*value = (double)raw * ((double)enabled / (double)running);
+	}
+
+	return true;
+}
+
+/**
+ * @brief libperf_export_scrape - reads every registered tracker, writing them out as the response body
+ * @pre exporter->lock held
+ * @param libperf_exporter *const exporter - exporter
+ */
+static void libperf_export_scrape(libperf_exporter *const exporter)
+{
+	exporter->body_length = 0;
+	exporter->body_failed = false;
+	exporter->body[0] = '\0';
+
+	for (size_t t = 0; t < exporter->count; ++t) {
+		exporter->read[t] = libperf_snapshot_take(exporter->trackers[t], &exporter->current[t]) == LIBPERF_EXIT_SUCCESS;
+	}
+
+	/* samples of a metric family must be contiguous, so walk the trackers once per family */
+	libperf_export_append(exporter, "# TYPE libperf_events counter\n# HELP libperf_events Events counted, scaled to account for multiplexing.\n");
+	for (size_t t = 0; t < exporter->count; ++t) {
+		if (!exporter->read[t]) {
+			continue;
+		}
+
+		const struct libperf_snapshot *const snapshot = &exporter->current[t];
+		uint64_t scaled[LIBPERF_SNAPSHOT_MAX];
+		libperf_snapshot_scale(snapshot, scaled);
+		for (size_t i = 0; i < snapshot->count; ++i) {
+			libperf_export_append(exporter, "libperf_events_total");
+			libperf_export_labels(exporter, exporter->names[t], libperf_event_name(snapshot->events[i]));
+			libperf_export_append(exporter, " %lu\n", scaled[i]);
+		}
+	}
+
+	libperf_export_append(exporter, "# TYPE libperf_event_running_ratio gauge\n# HELP libperf_event_running_ratio Fraction of its enabled time each event was actually counted for.\n");
+	for (size_t t = 0; t < exporter->count; ++t) {
+		if (!exporter->read[t]) {
+			continue;
+		}
+
+		const struct libperf_snapshot *const snapshot = &exporter->current[t];
+		for (size_t i = 0; i < snapshot->count; ++i) {
+			if (snapshot->time_enabled[i] == 0) { // never enabled, so there's no ratio to speak of
+				continue;
+			}
+			libperf_export_append(exporter, "libperf_event_running_ratio");
+			libperf_export_labels(exporter, exporter->names[t], libperf_event_name(snapshot->events[i]));
+			libperf_export_append(exporter, " %.9g\n", (double)snapshot->time_running[i] / (double)snapshot->time_enabled[i]);
+		}
+	}
+
+	for (size_t r = 0; r < sizeof(libperf_export_ratios) / sizeof(libperf_export_ratios[0]); ++r) {
+		const struct libperf_export_ratio *const ratio = &libperf_export_ratios[r];
+		bool described = false; // families are only described once they've a sample
+
+		for (size_t t = 0; t < exporter->count; ++t) {
+			double numerator, denominator;
+			if (!exporter->read[t]
+				|| !libperf_export_interval(&exporter->current[t], &exporter->previous[t], ratio->numerator, &numerator)
+				|| !libperf_export_interval(&exporter->current[t], &exporter->previous[t], ratio->denominator, &denominator)
+				|| denominator == 0.0) {
+				continue;
+			}
+
+			if (!described) {
+				libperf_export_append(exporter, "# TYPE %s gauge\n# HELP %s %s\n", ratio->name, ratio->name, ratio->help);
+				described = true;
+			}
+			libperf_export_append(exporter, "%s", ratio->name);
+			libperf_export_labels(exporter, exporter->names[t], NULL);
+			libperf_export_append(exporter, " %.9g\n", numerator / denominator);
+		}
+	}
+
+	libperf_export_append(exporter, "# EOF\n");
+
+	for (size_t t = 0; t < exporter->count; ++t) {
+		if (exporter->read[t]) {
+			exporter->previous[t] = exporter->current[t];
+		}
+	}
+}
+
+/**
+ * @brief libperf_export_send - writes a whole buffer out to a client
+ * @param const int client - client socket
+ * @param const char *const data - data
+ * @param const size_t length - length of data
+ * @return bool - whether all of it was written
+ */
+static bool libperf_export_send(const int client, const char *const data, const size_t length)
+{
+	size_t sent = 0;
+	while (sent < length) {
+		const ssize_t rt = send(client, data + sent, length - sent, MSG_NOSIGNAL); // a client hanging up mustn't raise SIGPIPE
+		if (rt < 0 && errno == EINTR) {
+			continue;
+		} else if (rt <= 0) {
+			return false;
+		}
+		sent += (size_t)rt;
+	}
+
+	return true;
+}
+
+/**
+ * @brief libperf_export_serve - reads a client's HTTP request & responds to it
+ * @param libperf_exporter *const exporter - exporter
+ * @param const int client - client socket
+ */
+static void libperf_export_serve(libperf_exporter *const exporter, const int client)
+{
+	const struct timeval timeout = { LIBPERF_EXPORT_TIMEOUT, 0 };
+	setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	char request[LIBPERF_EXPORT_REQUEST];
+	size_t length = 0;
+	bool complete = false; // whether the request head (up to its blank line) fit in request
+	while (length < sizeof(request) - 1) {
+		const ssize_t rt = recv(client, request + length, sizeof(request) - 1 - length, 0);
+		if (rt < 0 && errno == EINTR) {
+			continue;
+		} else if (rt <= 0) { // hung up, or timed out
+			return;
+		}
+		length += (size_t)rt;
+		request[length] = '\0';
+		if (strstr(request, "\r\n\r\n") != NULL || strstr(request, "\n\n") != NULL) {
+			complete = true;
+			break;
+		}
+	}
+	request[length] = '\0';
+
+	/* request line: <method> <target> <version> */
+	const char *status = "200 OK";
+	const size_t method = strcspn(request, " ");
+	const char *const target = request + method + (request[method] == ' ' ? 1 : 0);
+	const size_t path = strcspn(target, " ?");
+	if (!complete) { // rather than acting on a request only partly read
+		status = "431 Request Header Fields Too Large";
+	} else if (method != 3 || strncmp(request, "GET", 3) != 0) {
+		status = "405 Method Not Allowed";
+	} else if (!(path == 1 && target[0] == '/') && !(path == 8 && strncmp(target, "/metrics", 8) == 0)) {
+		status = "404 Not Found";
+	}
+
+	const char *body = "";
+	size_t body_length = 0;
+	const char *type = "text/plain; charset=utf-8";
+	const bool scraped = status[0] == '2';
+	if (scraped) {
+		/* sending can take as long as the client lets it, so application threads (un)registering mustn't wait on that */
+		pthread_mutex_lock(&exporter->lock);
+		libperf_export_scrape(exporter);
+		pthread_mutex_unlock(&exporter->lock);
+		__atomic_add_fetch(&exporter->scrapes, 1, __ATOMIC_RELAXED);
+
+		if (exporter->body_failed) {
+			status = "500 Internal Server Error";
+		} else {
+			body = exporter->body;
+			body_length = exporter->body_length;
+			type = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+		}
+	}
+
+	char head[256];
+	const int head_length = snprintf(head, sizeof(head), "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %lu\r\nConnection: close\r\n\r\n", status, type, body_length);
+	if (libperf_export_send(client, head, (size_t)head_length)) {
+		libperf_export_send(client, body, body_length);
+	}
+}
+
+/**
+ * @brief libperf_export_run - body of exporter thread
+ * @param void *const arg - exporter
+ * @return void* - NULL
+ */
+static void *libperf_export_run(void *const arg)
+{
+	libperf_exporter *const exporter = arg;
+
+	for (;;) {
+		struct pollfd fds[2] = {
+			{ .fd = exporter->listener, .events = POLLIN, .revents = 0 },
+			{ .fd = exporter->wake[0], .events = POLLIN, .revents = 0 }
+		};
+		if (poll(fds, 2, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			libperf_diag(LOG_ERR, "libperf (in %s): unable to wait for clients, so exporter exiting", __func__);
+			break;
+		}
+
+		if (fds[1].revents != 0) { // asked to stop
+			break;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			const int client = accept4(exporter->listener, NULL, NULL, SOCK_CLOEXEC);
+			if (client >= 0) {
+				libperf_export_serve(exporter, client);
+				close(client);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief libperf_export_release - releases an exporter's resources, bar its thread
+ * @note errno is preserved, so callers can bail out of initialisation with it intact
+ * @param libperf_exporter *const exporter - exporter to release
+ */
+static void libperf_export_release(libperf_exporter *const exporter)
+{
+	const int err = errno;
+
+	close(exporter->listener);
+	if (exporter->path[0] != '\0') {
+		unlink(exporter->path);
+	}
+	if (exporter->wake[0] >= 0) {
+		close(exporter->wake[0]);
+		close(exporter->wake[1]);
+	}
+
+	pthread_mutex_destroy(&exporter->lock);
+	free(exporter->body);
+	free(exporter->read);
+	free(exporter->previous);
+	free(exporter->current);
+	free(exporter);
+
+	errno = err;
+}
+
+/**
+ * @brief libperf_export_spawn - creates an exporter around a listening socket, starting its thread
+ * @param const int listener - listening socket, handed over to the exporter (closed on failure)
+ * @param const char *const path - path of Unix domain socket (or NULL if TCP)
+ * @param const uint16_t port - TCP port (or 0 if a Unix domain socket)
+ * @param const char *const caller - name of API function, for logging
+ * @return libperf_exporter* - handle, or NULL with errno set
+ */
+static libperf_exporter *libperf_export_spawn(const int listener, const char *const path, const uint16_t port, const char *const caller)
+{
+	libperf_exporter *const exporter = calloc(1, sizeof(libperf_exporter));
+	if (exporter == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", caller);
+		close(listener);
+		if (path != NULL) {
+			unlink(path);
+		}
+		return NULL;
+	}
+	exporter->listener = listener;
+	exporter->wake[0] = -1;
+	exporter->port = port;
+	if (path != NULL) {
+		strcpy(exporter->path, path); // length already checked against sun_path
+	}
+	pthread_mutex_init(&exporter->lock, NULL);
+
+	exporter->body_size = 4096;
+	exporter->body = malloc(exporter->body_size);
+	exporter->read = calloc(LIBPERF_EXPORT_MAX, sizeof(bool));
+	if (posix_memalign((void **)&exporter->current, 64, LIBPERF_EXPORT_MAX * sizeof(struct libperf_snapshot)) != 0) { // snapshots are cache aligned
+		exporter->current = NULL;
+	}
+	if (posix_memalign((void **)&exporter->previous, 64, LIBPERF_EXPORT_MAX * sizeof(struct libperf_snapshot)) != 0) {
+		exporter->previous = NULL;
+	}
+	if (exporter->body == NULL || exporter->read == NULL || exporter->current == NULL || exporter->previous == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for snapshots", caller);
+		errno = ENOMEM;
+		libperf_export_release(exporter);
+		return NULL;
+	}
+
+	if (pipe2(exporter->wake, O_CLOEXEC) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to create pipe to stop exporter", caller);
+		exporter->wake[0] = -1;
+		libperf_export_release(exporter);
+		return NULL;
+	}
+
+	/* exporter thread inherits a fully blocked signal mask, so the application's handlers never run on it */
+	sigset_t all, previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &previous);
+	const int err = pthread_create(&exporter->thread, NULL, libperf_export_run, exporter);
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+	if (err != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to create exporter thread", caller);
+		errno = err;
+		libperf_export_release(exporter);
+		return NULL;
+	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): exporter started", caller);
+	return exporter;
+}
+
+libperf_exporter *libperf_export_start_unix(const char *const path)
+{
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+
+	if (path == NULL || path[0] == '\0' || strlen(path) >= sizeof(address.sun_path)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid socket path supplied", __func__);
+		errno = path == NULL || path[0] == '\0' ? EINVAL : ENAMETOOLONG;
+		return NULL;
+	}
+	strcpy(address.sun_path, path);
+
+	struct stat status;
+	if (lstat(path, &status) == 0 && S_ISSOCK(status.st_mode)) { // left behind by a previous run
+		unlink(path);
+	}
+
+	const int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (listener < 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to create socket", __func__);
+		return NULL;
+	}
+
+	if (bind(listener, (const struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+		const int err = errno;
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to listen on '%s'", __func__, path);
+		close(listener);
+		errno = err;
+		return NULL;
+	}
+
+	return libperf_export_spawn(listener, path, 0, __func__);
+}
+
+libperf_exporter *libperf_export_start_tcp(const uint16_t port)
+{
+	const int listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (listener < 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to create socket", __func__);
+		return NULL;
+	}
+
+	const int reuse = 1; // restarting the application shouldn't have to wait out TIME_WAIT
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	socklen_t length = sizeof(address);
+	if (bind(listener, (const struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0
+		|| getsockname(listener, (struct sockaddr *)&address, &length) != 0) {
+		const int err = errno;
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to listen on port %u", __func__, port);
+		close(listener);
+		errno = err;
+		return NULL;
+	}
+
+	return libperf_export_spawn(listener, NULL, ntohs(address.sin_port), __func__);
+}
+
+uint16_t libperf_export_port(const libperf_exporter *const exporter)
+{
+	if (exporter == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return exporter->port;
+}
+
+enum libperf_exit libperf_export_register(libperf_exporter *const exporter, libperf_tracker *const pd, const char *const name)
+{
+	if (exporter == NULL || pd == NULL || name == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (libperf_get_read_mode(pd) != LIBPERF_READ_MODE_SYSCALL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): exported trackers must be read with syscalls", __func__);
+		return LIBPERF_EXIT_READ_MODE_UNSUPPORTED;
+	}
+
+	pthread_mutex_lock(&exporter->lock);
+	if (exporter->count == LIBPERF_EXPORT_MAX) {
+		pthread_mutex_unlock(&exporter->lock);
+		libperf_diag(LOG_ERR, "libperf (in %s): exporter already serves %d trackers", __func__, LIBPERF_EXPORT_MAX);
+		errno = ENOSPC;
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	const size_t slot = exporter->count++;
+	exporter->trackers[slot] = pd;
+	snprintf(exporter->names[slot], LIBPERF_EXPORT_NAME, "%s", name);
+	exporter->previous[slot].mask = 0;
+	exporter->previous[slot].count = 0;
+	pthread_mutex_unlock(&exporter->lock);
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_export_unregister(libperf_exporter *const exporter, libperf_tracker *const pd)
+{
+	if (exporter == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	pthread_mutex_lock(&exporter->lock);
+	for (size_t t = 0; t < exporter->count; ++t) {
+		if (exporter->trackers[t] != pd) {
+			continue;
+		}
+
+		const size_t last = --exporter->count; // order of trackers is immaterial, so fill the gap with the last
+		if (t != last) {
+			exporter->trackers[t] = exporter->trackers[last];
+			memcpy(exporter->names[t], exporter->names[last], LIBPERF_EXPORT_NAME);
+			exporter->previous[t] = exporter->previous[last];
+		}
+		pthread_mutex_unlock(&exporter->lock);
+		return LIBPERF_EXIT_SUCCESS;
+	}
+	pthread_mutex_unlock(&exporter->lock);
+
+	libperf_diag(LOG_ERR, "libperf (in %s): tracker isn't registered", __func__);
+	return LIBPERF_EXIT_HANDLE_INVALID;
+}
+
+uint64_t libperf_export_scrapes(const libperf_exporter *const exporter)
+{
+	if (exporter == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return __atomic_load_n(&exporter->scrapes, __ATOMIC_RELAXED);
+}
+
+void libperf_export_stop(libperf_exporter *const exporter)
+{
+	if (exporter == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return;
+	}
+
+	const char byte = 1;
+	while (write(exporter->wake[1], &byte, 1) < 0 && errno == EINTR);
+	pthread_join(exporter->thread, NULL);
+
+	libperf_export_release(exporter);
+
+	libperf_diag(LOG_NOTICE, "libperf (in %s): exporter stopped", __func__);
+}
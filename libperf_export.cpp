@@ -0,0 +1,101 @@
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_export.h"
+
+#include "libperf.hpp"
+#include "libperf_export.hpp"
+
+/**
+ * @brief Definitions of libperf metrics exporter API in C++
+ * @author Salih MSA
+ */
+
+libperf::Exporter::Exporter(const char *const path) noexcept(false)
+{
+	this->_exporter = libperf_export_start_unix(path) ;
+	if(this->_exporter == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Exporter::Exporter(const std::uint16_t port) noexcept(false)
+{
+	this->_exporter = libperf_export_start_tcp(port) ;
+	if(this->_exporter == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Exporter::Exporter(libperf::Exporter&& exporter) noexcept
+{
+	this->_exporter = exporter._exporter ;
+	exporter._exporter = nullptr ;
+}
+
+libperf::Exporter& libperf::Exporter::operator=(libperf::Exporter&& exporter) noexcept
+{
+	if(this != &exporter)
+	{
+		if(this->_exporter != nullptr)
+		{
+			libperf_export_stop(this->_exporter) ;
+		}
+		this->_exporter = exporter._exporter ;
+		exporter._exporter = nullptr ;
+	}
+
+	return *this ;
+}
+
+void libperf::Exporter::add(libperf::Tracker& tracker, const char *const name) noexcept(false)
+{
+	const auto err = libperf_export_register(this->_exporter, tracker.handle(), name) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+void libperf::Exporter::remove(libperf::Tracker& tracker) noexcept(false)
+{
+	const auto err = libperf_export_unregister(this->_exporter, tracker.handle()) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+std::uint16_t libperf::Exporter::port() const noexcept
+{
+	return libperf_export_port(this->_exporter) ;
+}
+
+std::uint64_t libperf::Exporter::scrapes() const noexcept
+{
+	return libperf_export_scrapes(this->_exporter) ;
+}
+
+libperf::Exporter::~Exporter() noexcept
+{
+	if(this->_exporter != nullptr)
+	{
+		libperf_export_stop(this->_exporter) ;
+	}
+}
@@ -0,0 +1,93 @@
+#ifndef LIBPERF_EXPORT_H
+#define LIBPERF_EXPORT_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf metrics exporter API
+ * @note An exporter owns a thread serving the counters of registered trackers in OpenMetrics text format (as scraped by Prometheus) over HTTP, on a Unix domain socket or loopback TCP port. Counters are read on that thread, without taking trackers' locks, so application threads are never held up by a scrape
+ * @note Each scrape exposes, per tracker & event, libperf_events_total (scaled to account for multiplexing) and libperf_event_running_ratio, alongside ratios derived over the interval since the previous scrape - libperf_ipc, libperf_cache_miss_ratio, libperf_llc_load_miss_ratio, libperf_dtlb_load_miss_ratio and libperf_branch_miss_ratio - wherever a tracker counts both events involved
+ * @author Salih MSA
+ */
+
+#define LIBPERF_EXPORT_MAX 64 // most trackers an exporter serves
+#define LIBPERF_EXPORT_NAME 64 // longest tracker name, including terminator
+
+struct libperf_exporter;
+typedef struct libperf_exporter libperf_exporter;
+
+/**
+ * @brief libperf_export_start_unix - function starts an exporter listening on a Unix domain socket
+ * @note A stale socket left at path is replaced, and the socket is removed once stopped
+ * @param const char *const path - path of socket, e.g. /run/app/metrics.sock (scrape with e.g. curl --unix-socket <path> http://localhost/metrics)
+ * @return libperf_exporter* - handle for use in future library calls
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_exporter *libperf_export_start_unix(const char *const path);
+
+/**
+ * @brief libperf_export_start_tcp - function starts an exporter listening on a loopback TCP port
+ * @note Only 127.0.0.1 is listened on, so counters aren't exposed beyond the host
+ * @param const uint16_t port - port, or 0 for any free one (see libperf_export_port())
+ * @return libperf_exporter* - handle for use in future library calls
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_exporter *libperf_export_start_tcp(const uint16_t port);
+
+/**
+ * @brief libperf_export_port - function obtains which TCP port an exporter listens on
+ * @param const libperf_exporter *const exporter - handle obtained from libperf_export_start_tcp()
+ * @return uint16_t - port, or 0 if exporter listens on a Unix domain socket or the handle is invalid
+ */
+uint16_t libperf_export_port(const libperf_exporter *const exporter);
+
+/**
+ * @brief libperf_export_register - function adds a tracker to those an exporter serves
+ * @pre Tracker must use LIBPERF_READ_MODE_SYSCALL (see libperf_set_read_mode()), as userspace reads only work on the monitored thread itself
+ * @pre libperf_fini() must not be called on the tracker until it's unregistered (or the exporter stopped)
+ * @param libperf_exporter *const exporter - handle obtained from libperf_export_start_unix() or libperf_export_start_tcp()
+ * @param libperf_tracker *const pd - library structure obtained from libperf_initialise()
+ * @param const char *const name - value of the tracker label, e.g. a process or component name; truncated to LIBPERF_EXPORT_NAME - 1 characters
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_SYSTEM_ERROR with errno of ENOSPC if LIBPERF_EXPORT_MAX trackers are registered already
+ */
+enum libperf_exit libperf_export_register(libperf_exporter *const exporter, libperf_tracker *const pd, const char *const name);
+
+/**
+ * @brief libperf_export_unregister - function removes a tracker from those an exporter serves
+ * @note Waits for a scrape reading trackers to finish (though not for its response to be sent), after which the tracker is no longer used by the exporter
+ * @param libperf_exporter *const exporter - handle obtained from libperf_export_start_unix() or libperf_export_start_tcp()
+ * @param libperf_tracker *const pd - tracker previously registered
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_HANDLE_INVALID if tracker wasn't registered
+ */
+enum libperf_exit libperf_export_unregister(libperf_exporter *const exporter, libperf_tracker *const pd);
+
+/**
+ * @brief libperf_export_scrapes - function obtains how many scrapes an exporter has served
+ * @param const libperf_exporter *const exporter - handle obtained from libperf_export_start_unix() or libperf_export_start_tcp()
+ * @return uint64_t - number of scrapes
+ */
+uint64_t libperf_export_scrapes(const libperf_exporter *const exporter);
+
+/**
+ * @brief libperf_export_stop - function stops & joins the exporter thread, closing its socket
+ * @note Blocks for up to the time a scrape in progress takes to serve
+ * @param libperf_exporter *const exporter - handle obtained from libperf_export_start_unix() or libperf_export_start_tcp()
+ */
+void libperf_export_stop(libperf_exporter *const exporter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_EXPORT_H
@@ -0,0 +1,100 @@
+#ifndef LIBPERF_EXPORT_HPP
+#define LIBPERF_EXPORT_HPP
+#pragma once
+
+#include <cstdint>
+
+#include "libperf.hpp"
+#include "libperf_export.h"
+
+/**
+ * @brief Declarations of libperf metrics exporter API for C++
+ * @note Access to exporters in C++ in via an RAII-complaint container
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	class Exporter {
+		private:
+			libperf_exporter* _exporter ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief Exporter (constructor) - starts an exporter listening on a Unix domain socket
+			 * @note Stub to libperf_export_start_unix()
+			 * @param const char *const path - path of socket
+			 * @throws std::system_error - thrown if the exporter couldn't be started, with the errno which caused it
+			 */
+			explicit Exporter(const char *const path) noexcept(false) ;
+
+			/**
+			 * @brief Exporter (constructor) - starts an exporter listening on a loopback TCP port
+			 * @note Stub to libperf_export_start_tcp()
+			 * @param const std::uint16_t port - port, or 0 for any free one
+			 * @throws std::system_error - thrown if the exporter couldn't be started, with the errno which caused it
+			 */
+			explicit Exporter(const std::uint16_t port) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as there's one exporter thread
+			 */
+			Exporter(const Exporter& exporter) noexcept(false) = delete ;
+			Exporter& operator=(const Exporter& exporter) noexcept(false) = delete ;
+
+			/**
+			 * @brief Exporter (move constructor) - acquire existing exporter
+			 * @param Exporter&& exporter - exporter to acquire
+			 */
+			explicit Exporter(Exporter&& exporter) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing exporter, stopping the one held
+			 * @param Exporter&& exporter - exporter to acquire
+			 * @return Exporter& - object which acquired
+			 */
+			Exporter& operator=(Exporter&& exporter) noexcept ;
+
+			/**
+			 * @brief add - method adds a tracker to those served
+			 * @note Stub to libperf_export_register()
+			 * @pre tracker must use libperf_read_mode::LIBPERF_READ_MODE_SYSCALL, and outlive its registration
+			 * @param Tracker& tracker - tracker to serve
+			 * @param const char *const name - value of the tracker label
+			 * @throws std::system_error - thrown if the tracker couldn't be added
+			 */
+			void add(Tracker& tracker, const char *const name) noexcept(false) ;
+
+			/**
+			 * @brief remove - method removes a tracker from those served
+			 * @note Stub to libperf_export_unregister()
+			 * @param Tracker& tracker - tracker previously added
+			 * @throws std::system_error - thrown if the tracker wasn't added
+			 */
+			void remove(Tracker& tracker) noexcept(false) ;
+
+			/**
+			 * @brief port - method obtains which TCP port is listened on
+			 * @note Stub to libperf_export_port()
+			 * @return std::uint16_t - port, or 0 if listening on a Unix domain socket
+			 */
+			std::uint16_t port() const noexcept ;
+
+			/**
+			 * @brief scrapes - method obtains how many scrapes have been served
+			 * @note Stub to libperf_export_scrapes()
+			 * @return std::uint64_t - number of scrapes
+			 */
+			std::uint64_t scrapes() const noexcept ;
+
+			/**
+			 * @brief ~Exporter - stops & joins the exporter thread
+			 * @note Stub to libperf_export_stop()
+			 */
+			~Exporter() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_EXPORT_HPP
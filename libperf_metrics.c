@@ -0,0 +1,310 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <errno.h>
+#include <sys/types.h>
+
+#include <linux/perf_event.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_pmu.h"
+#include "libperf_metrics.h"
+
+/**
+ * @brief Definitions of libperf derived metrics API and inner functionality
+ * @author Salih MSA
+ */
+
+struct libperf_metric_definition {
+	const char *name;
+	enum libperf_event numerator;
+	enum libperf_event denominator;
+};
+
+static const struct libperf_metric_definition libperf_metric_definitions[LIBPERF_METRIC_COUNT] = {
+	/* index using enum to get definition */
+	{ "IPC", LIBPERF_EVENT_HW_INSTRUCTIONS, LIBPERF_EVENT_HW_CPU_CYCLES },
+	{ "CPI", LIBPERF_EVENT_HW_CPU_CYCLES, LIBPERF_EVENT_HW_INSTRUCTIONS },
+	{ "BRANCH_MISS_RATE", LIBPERF_EVENT_HW_BRANCH_MISSES, LIBPERF_EVENT_HW_BRANCH_INSTRUCTIONS },
+	{ "CACHE_MISS_RATIO", LIBPERF_EVENT_HW_CACHE_MISSES, LIBPERF_EVENT_HW_CACHE_REFERENCES },
+	{ "L1D_LOAD_MISS_RATIO", LIBPERF_EVENT_HW_CACHE_L1D_LOADS_MISSES, LIBPERF_EVENT_HW_CACHE_L1D_LOADS },
+	{ "L1I_LOAD_MISS_RATIO", LIBPERF_EVENT_HW_CACHE_L1I_LOADS_MISSES, LIBPERF_EVENT_HW_CACHE_L1I_LOADS },
+	{ "LL_LOAD_MISS_RATIO", LIBPERF_EVENT_HW_CACHE_LL_LOADS_MISSES, LIBPERF_EVENT_HW_CACHE_LL_LOADS },
+	{ "DTLB_LOAD_MISS_RATIO", LIBPERF_EVENT_HW_CACHE_DTLB_LOADS_MISSES, LIBPERF_EVENT_HW_CACHE_DTLB_LOADS },
+
+	/* the kernel reports each topdown-* event in issue slots, so every category is simply a share of slots */
+	{ "TOPDOWN_RETIRING", LIBPERF_EVENT_CUSTOM_N(1), LIBPERF_EVENT_CUSTOM_N(0) },
+	{ "TOPDOWN_BAD_SPECULATION", LIBPERF_EVENT_CUSTOM_N(2), LIBPERF_EVENT_CUSTOM_N(0) },
+	{ "TOPDOWN_FRONTEND_BOUND", LIBPERF_EVENT_CUSTOM_N(3), LIBPERF_EVENT_CUSTOM_N(0) },
+	{ "TOPDOWN_BACKEND_BOUND", LIBPERF_EVENT_CUSTOM_N(4), LIBPERF_EVENT_CUSTOM_N(0) }
+};
+
+static const char *const libperf_metric_topdown_events[LIBPERF_METRIC_TOPDOWN_EVENTS] = { // slots must lead the group
+	"slots", "topdown-retiring", "topdown-bad-spec", "topdown-fe-bound", "topdown-be-bound"
+};
+
+struct libperf_metric_group { /* counters shared by one or more metrics */
+	libperf_tracker *pd; // group tracker
+	uint64_t events; // mask of its events
+	uint64_t metrics; // mask of metrics computed from it
+	enum libperf_event members[LIBPERF_METRIC_TOPDOWN_EVENTS]; // events in the order they were opened, ie read back
+	size_t members_count;
+};
+
+struct libperf_metrics { /* lib struct */
+	size_t count; // number of groups
+	struct libperf_metric_group groups[LIBPERF_METRIC_COUNT]; // at most one per metric
+	uint64_t available; // mask of metrics opened
+};
+
+const char *libperf_metric_name(const enum libperf_metric metric)
+{
+	if (metric < 0 || metric >= LIBPERF_METRIC_COUNT) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid metric '%d' supplied", __func__, metric);
+		return NULL;
+	}
+
+	return libperf_metric_definitions[metric].name;
+}
+
+uint64_t libperf_metric_events(const enum libperf_metric metric)
+{
+	if (metric < 0 || metric >= LIBPERF_METRIC_COUNT) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid metric '%d' supplied", __func__, metric);
+		return 0;
+	}
+
+	if (LIBPERF_METRIC_MASK(metric) & LIBPERF_METRIC_MASK_TOPDOWN) { // categories are only meaningful measured together
+		return (LIBPERF_EVENT_MASK(LIBPERF_EVENT_CUSTOM_N(LIBPERF_METRIC_TOPDOWN_EVENTS)) - 1) & LIBPERF_EVENT_MASK_CUSTOM;
+	}
+
+	return LIBPERF_EVENT_MASK(libperf_metric_definitions[metric].numerator) | LIBPERF_EVENT_MASK(libperf_metric_definitions[metric].denominator);
+}
+
+double libperf_metric_compute(const enum libperf_metric metric, const uint64_t *const values)
+{
+	if (metric < 0 || metric >= LIBPERF_METRIC_COUNT) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid metric '%d' supplied", __func__, metric);
+		return NAN;
+	}
+
+	const uint64_t denominator = values[libperf_metric_definitions[metric].denominator];
+	if (denominator == 0) {
+		return NAN;
+	}
+
+	return (double)values[libperf_metric_definitions[metric].numerator] / (double)denominator;
+}
+
+/**
+ * @brief libperf_metrics_open_error_fatal - decides whether a group failing to open should abort initialisation, rather than leave its metrics out
+ * @param const int err - errno left by opening the group
+ * @return bool - true if the error is down to the caller / runtime rather than the PMU
+ */
+static inline bool libperf_metrics_open_error_fatal(const int err)
+{
+	return err == EACCES || err == EPERM || err == EMFILE || err == ENFILE || err == ENOMEM || err == ESRCH || err == EBADF || err == EFAULT;
+}
+
+/**
+ * @brief libperf_metrics_open_group - opens the counters of a metric as a group
+ * @param struct libperf_metric_group *const group - group to open, whose events are set
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @param const int cpu - cpuid to track
+ * @param const bool topdown - whether group holds the top-down events
+ * @return bool - whether group was opened, errno set otherwise
+ */
+static bool libperf_metrics_open_group(struct libperf_metric_group *const group, const pid_t id, const int cpu, const bool topdown)
+{
+	if (!topdown) {
+		group->pd = libperf_init_group(id, cpu, group->members, group->members_count);
+		return group->pd != NULL;
+	}
+
+	struct perf_event_attr attrs[LIBPERF_METRIC_TOPDOWN_EVENTS];
+	for (size_t i = 0; i < LIBPERF_METRIC_TOPDOWN_EVENTS; ++i) {
+		if (libperf_pmu_parse(libperf_metric_topdown_events[i], &attrs[i]) != LIBPERF_EXIT_SUCCESS) {
+			errno = ENOENT;
+			return false;
+		}
+		if (id != -1) { // as with other counters, stick to userspace unless doing system wide analysis
+			attrs[i].exclude_kernel = 1;
+			attrs[i].exclude_hv = 1;
+		}
+	}
+
+	group->pd = libperf_init_explicit(id, cpu, attrs, LIBPERF_METRIC_TOPDOWN_EVENTS, LIBPERF_INIT_GROUP);
+	return group->pd != NULL;
+}
+
+libperf_metrics *libperf_metrics_init(const pid_t id, const int cpu, const uint64_t metrics)
+{
+	if (metrics == 0 || (metrics & ~LIBPERF_METRIC_MASK_ALL) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid metrics '%#lx' supplied", __func__, metrics);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	libperf_metrics *pm = malloc(sizeof(libperf_metrics));
+	if (pm == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", __func__);
+		return NULL;
+	}
+	pm->count = 0;
+	pm->available = 0;
+
+	/* metrics over the same counters (e.g. IPC & CPI) share a group */
+	for (size_t m = 0; m < LIBPERF_METRIC_COUNT; ++m) {
+		if ((metrics & LIBPERF_METRIC_MASK(m)) == 0) {
+			continue;
+		}
+
+		const uint64_t events = libperf_metric_events((enum libperf_metric)m);
+		size_t g = 0;
+		while (g < pm->count && pm->groups[g].events != events) {
+			++g;
+		}
+
+		if (g == pm->count) {
+			struct libperf_metric_group *const group = &pm->groups[pm->count++];
+			group->events = events;
+			group->metrics = 0;
+
+			const bool topdown = (LIBPERF_METRIC_MASK(m) & LIBPERF_METRIC_MASK_TOPDOWN) != 0;
+			if (topdown) {
+				group->members_count = LIBPERF_METRIC_TOPDOWN_EVENTS;
+				for (size_t i = 0; i < LIBPERF_METRIC_TOPDOWN_EVENTS; ++i) {
+					group->members[i] = LIBPERF_EVENT_CUSTOM_N(i);
+				}
+			} else { // denominator leads, it generally being the fixed cycle or access count
+				group->members_count = 2;
+				group->members[0] = libperf_metric_definitions[m].denominator;
+				group->members[1] = libperf_metric_definitions[m].numerator;
+			}
+
+			if (!libperf_metrics_open_group(group, id, cpu, topdown)) {
+				if (libperf_metrics_open_error_fatal(errno)) {
+					libperf_diag(LOG_ERR, "libperf (in %s): aborting initialisation", __func__);
+					const int err = errno;
+					--pm->count;
+					libperf_metrics_fini(pm);
+					errno = err;
+					return NULL;
+				}
+				libperf_diag(LOG_WARNING, "libperf (in %s): metric '%s' unsupported but continuing", __func__, libperf_metric_definitions[m].name);
+			}
+		}
+
+		if (pm->groups[g].pd != NULL) {
+			pm->groups[g].metrics |= LIBPERF_METRIC_MASK(m);
+			pm->available |= LIBPERF_METRIC_MASK(m);
+		}
+	}
+
+	if (pm->available == 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): none of the metrics are supported", __func__);
+		libperf_metrics_fini(pm);
+		errno = ENOENT;
+		return NULL;
+	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): metrics initialised", __func__);
+	return pm;
+}
+
+uint64_t libperf_metrics_available(const libperf_metrics *const pm)
+{
+	if (pm == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return pm->available;
+}
+
+enum libperf_exit libperf_metrics_toggle(libperf_metrics *const pm, const enum libperf_event_toggle toggle_type)
+{
+	if (pm == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	for (size_t g = 0; g < pm->count; ++g) {
+		if (pm->groups[g].pd == NULL) {
+			continue;
+		}
+
+		const enum libperf_exit rt = libperf_toggle_counters(pm->groups[g].pd, pm->groups[g].events, toggle_type);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_metrics_read(libperf_metrics *const pm, double *const values)
+{
+	if (pm == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	for (size_t m = 0; m < LIBPERF_METRIC_COUNT; ++m) {
+		values[m] = NAN;
+	}
+
+	for (size_t g = 0; g < pm->count; ++g) {
+		const struct libperf_metric_group *const group = &pm->groups[g];
+		if (group->pd == NULL) {
+			continue;
+		}
+
+		struct libperf_counter_value read[LIBPERF_METRIC_TOPDOWN_EVENTS];
+		const enum libperf_exit rt = libperf_read_group_scaled(group->pd, read);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+
+		if (read[0].time_running == 0) { // group never made it onto the PMU, so there's nothing to go by
+			continue;
+		}
+
+		/* members ran over the same window, so raw values are consistent with one another without scaling */
+		uint64_t by_event[LIBPERF_EVENT_SLOTS];
+		for (size_t i = 0; i < group->members_count; ++i) {
+			by_event[group->members[i]] = read[i].raw;
+		}
+
+		for (size_t m = 0; m < LIBPERF_METRIC_COUNT; ++m) {
+			if (group->metrics & LIBPERF_METRIC_MASK(m)) {
+				values[m] = libperf_metric_compute((enum libperf_metric)m, by_event);
+			}
+		}
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+void libperf_metrics_fini(libperf_metrics *const pm)
+{
+	if (pm == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return;
+	}
+
+	for (size_t g = 0; g < pm->count; ++g) {
+		if (pm->groups[g].pd != NULL) {
+			libperf_fini(pm->groups[g].pd);
+		}
+	}
+	free(pm);
+
+	libperf_diag(LOG_NOTICE, "libperf (in %s): metrics shut down", __func__);
+}
@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_metrics.h"
+
+#include "libperf.hpp"
+#include "libperf_metrics.hpp"
+
+/**
+ * @brief Definitions of libperf derived metrics API in C++
+ * @author Salih MSA
+ */
+
+libperf::Metrics::Metrics(const pid_t pid, const int cpu, const std::uint64_t metrics) noexcept(false)
+{
+	this->_metrics = libperf_metrics_init(pid, cpu, metrics) ;
+	if(this->_metrics == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Metrics::Metrics(libperf::Metrics&& metrics) noexcept
+{
+	this->_metrics = metrics._metrics ;
+	metrics._metrics = nullptr ;
+}
+
+libperf::Metrics& libperf::Metrics::operator=(libperf::Metrics&& metrics) noexcept
+{
+	if(this != &metrics)
+	{
+		if(this->_metrics != nullptr)
+		{
+			libperf_metrics_fini(this->_metrics) ;
+		}
+		this->_metrics = metrics._metrics ;
+		metrics._metrics = nullptr ;
+	}
+
+	return *this ;
+}
+
+std::uint64_t libperf::Metrics::available() const noexcept
+{
+	return libperf_metrics_available(this->_metrics) ;
+}
+
+void libperf::Metrics::toggle(const libperf_event_toggle toggle_type) noexcept(false)
+{
+	const auto err = libperf_metrics_toggle(this->_metrics, toggle_type) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+void libperf::Metrics::read(double *const values) noexcept(false)
+{
+	const auto err = libperf_metrics_read(this->_metrics, values) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+libperf::Metrics::~Metrics() noexcept
+{
+	if(this->_metrics != nullptr)
+	{
+		libperf_metrics_fini(this->_metrics) ;
+	}
+}
@@ -0,0 +1,120 @@
+#ifndef LIBPERF_METRICS_H
+#define LIBPERF_METRICS_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf derived metrics API
+ * @note Metrics are ratios of counters. Each metric's counters are opened as their own group, so numerator & denominator are always measured over the same window, even when the kernel multiplexes groups
+ * @author Salih MSA
+ */
+
+struct libperf_metrics;
+typedef struct libperf_metrics libperf_metrics;
+
+enum libperf_metric {
+	LIBPERF_METRIC_IPC = 0, // instructions per cycle
+	LIBPERF_METRIC_CPI = 1, // cycles per instruction
+	LIBPERF_METRIC_BRANCH_MISS_RATE = 2, // mispredicted branches per branch
+	LIBPERF_METRIC_CACHE_MISS_RATIO = 3, // cache misses per cache reference
+	LIBPERF_METRIC_L1D_LOAD_MISS_RATIO = 4, // L1 data cache load misses per load
+	LIBPERF_METRIC_L1I_LOAD_MISS_RATIO = 5, // L1 instruction cache misses per fetch
+	LIBPERF_METRIC_LL_LOAD_MISS_RATIO = 6, // last level cache load misses per load
+	LIBPERF_METRIC_DTLB_LOAD_MISS_RATIO = 7, // data TLB load misses per load
+
+	/* top-down level 1, as fractions of issue slots; needs a PMU exporting slots & topdown-* events (e.g. Intel Ice Lake onwards) */
+	LIBPERF_METRIC_TOPDOWN_RETIRING = 8,
+	LIBPERF_METRIC_TOPDOWN_BAD_SPECULATION = 9,
+	LIBPERF_METRIC_TOPDOWN_FRONTEND_BOUND = 10,
+	LIBPERF_METRIC_TOPDOWN_BACKEND_BOUND = 11,
+
+	LIBPERF_METRIC_COUNT = 12 // number of metrics
+};
+
+#define LIBPERF_METRIC_MASK(metric) (UINT64_C(1) << (metric)) // bit selecting a metric in a metric mask
+#define LIBPERF_METRIC_MASK_TOPDOWN (LIBPERF_METRIC_MASK(LIBPERF_METRIC_TOPDOWN_RETIRING) | LIBPERF_METRIC_MASK(LIBPERF_METRIC_TOPDOWN_BAD_SPECULATION) | LIBPERF_METRIC_MASK(LIBPERF_METRIC_TOPDOWN_FRONTEND_BOUND) | LIBPERF_METRIC_MASK(LIBPERF_METRIC_TOPDOWN_BACKEND_BOUND))
+#define LIBPERF_METRIC_MASK_ALL (LIBPERF_METRIC_MASK(LIBPERF_METRIC_COUNT) - 1) // every metric
+
+#define LIBPERF_METRIC_TOPDOWN_EVENTS 5 // top-down events, opened as LIBPERF_EVENT_CUSTOM_N(0 ...) in the order: slots, topdown-retiring, topdown-bad-spec, topdown-fe-bound, topdown-be-bound
+
+/**
+ * @brief libperf_metric_name - function obtains the name of a metric (e.g. "IPC")
+ * @param const enum libperf_metric metric - metric
+ * @return const char* - name, or NULL if metric is invalid
+ */
+const char *libperf_metric_name(const enum libperf_metric metric);
+
+/**
+ * @brief libperf_metric_events - function obtains the counters a metric is computed from
+ * @param const enum libperf_metric metric - metric
+ * @return uint64_t - mask (see LIBPERF_EVENT_MASK) of events; for top-down metrics, LIBPERF_EVENT_CUSTOM_N(0 ... LIBPERF_METRIC_TOPDOWN_EVENTS - 1); 0 if metric is invalid
+ */
+uint64_t libperf_metric_events(const enum libperf_metric metric);
+
+/**
+ * @brief libperf_metric_compute - function computes a metric from a snapshot of counters
+ * @note Counters should come from one group, or at least the same window (e.g. libperf_read_enabled() of a group tracker); deltas between two snapshots work just as well
+ * @param const enum libperf_metric metric - metric
+ * @param const uint64_t *const values - array indexed by enum libperf_event (ie of LIBPERF_EVENT_SLOTS entries) holding at least the events of libperf_metric_events()
+ * @return double - value of metric, or NaN if it's invalid or its denominator is 0
+ */
+double libperf_metric_compute(const enum libperf_metric metric, const uint64_t *const values);
+
+/**
+ * @brief libperf_metrics_init - function opens exactly the counters a set of metrics needs, one group per distinct set of counters
+ * @note Metrics the system doesn't support (e.g. top-down on older PMUs) are left out, see libperf_metrics_available()
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @note Set -1 for system wide readings
+ * @param const int cpu - pass in specific cpuid to track
+ * @note Set -1 for aggregate readings (of all CPUs)
+ * @param const uint64_t metrics - mask (see LIBPERF_METRIC_MASK) of metrics wanted
+ * @return libperf_metrics* - handle for use in future library calls, initially disabled
+ * @note return NULL if failure occurs (including none of the metrics being supported), with errno set to the cause
+ */
+libperf_metrics *libperf_metrics_init(const pid_t id, const int cpu, const uint64_t metrics);
+
+/**
+ * @brief libperf_metrics_available - function obtains which of the metrics asked for could be opened
+ * @param const libperf_metrics *const pm - handle obtained from libperf_metrics_init()
+ * @return uint64_t - mask of metrics
+ */
+uint64_t libperf_metrics_available(const libperf_metrics *const pm);
+
+/**
+ * @brief libperf_metrics_toggle - function enables, disables or resets every group, each with a single ioctl
+ * @param libperf_metrics *const pm - handle obtained from libperf_metrics_init()
+ * @param const enum libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_metrics_toggle(libperf_metrics *const pm, const enum libperf_event_toggle toggle_type);
+
+/**
+ * @brief libperf_metrics_read - function reads every group and computes the metrics
+ * @param libperf_metrics *const pm - handle obtained from libperf_metrics_init()
+ * @param double *const values - array of LIBPERF_METRIC_COUNT entries, indexed by enum libperf_metric, to write metrics out to; metrics unavailable, or whose group hasn't run yet, are NaN
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_metrics_read(libperf_metrics *const pm, double *const values);
+
+/**
+ * @brief libperf_metrics_fini - function closes every group
+ * @param libperf_metrics *const pm - handle obtained from libperf_metrics_init()
+ */
+void libperf_metrics_fini(libperf_metrics *const pm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_METRICS_H
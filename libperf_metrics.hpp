@@ -0,0 +1,88 @@
+#ifndef LIBPERF_METRICS_HPP
+#define LIBPERF_METRICS_HPP
+#pragma once
+
+#include <cstdint>
+#include <sys/types.h>
+
+#include "libperf.hpp"
+#include "libperf_metrics.h"
+
+/**
+ * @brief Declarations of libperf derived metrics API for C++
+ * @note Access to metrics in C++ in via an RAII-complaint container
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	class Metrics {
+		private:
+			libperf_metrics* _metrics ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief Metrics (constructor) - opens the counters of a set of metrics
+			 * @note Stub to libperf_metrics_init()
+			 * @param const pid_t pid - process ID *or* thread ID to monitor
+			 * @param const int cpu - pass in specific cpuid to track
+			 * @param const std::uint64_t metrics - mask (see LIBPERF_METRIC_MASK) of metrics wanted
+			 * @throws std::system_error - thrown if none of the metrics could be opened, with the errno which caused it
+			 */
+			explicit Metrics(const pid_t pid, const int cpu, const std::uint64_t metrics) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as counters can't be shared
+			 */
+			Metrics(const Metrics& metrics) noexcept(false) = delete ;
+			Metrics& operator=(const Metrics& metrics) noexcept(false) = delete ;
+
+			/**
+			 * @brief Metrics (move constructor) - acquire existing metrics
+			 * @param Metrics&& metrics - metrics to acquire
+			 */
+			explicit Metrics(Metrics&& metrics) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing metrics, closing those held
+			 * @param Metrics&& metrics - metrics to acquire
+			 * @return Metrics& - object which acquired
+			 */
+			Metrics& operator=(Metrics&& metrics) noexcept ;
+
+			/**
+			 * @brief available - method obtains which of the metrics asked for could be opened
+			 * @note Stub to libperf_metrics_available()
+			 * @return std::uint64_t - mask of metrics
+			 */
+			std::uint64_t available() const noexcept ;
+
+			/**
+			 * @brief toggle - method enables, disables or resets every group
+			 * @note Stub to libperf_metrics_toggle()
+			 * @param const libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+			 * @throws std::system_error - thrown if we can't manipulate counters
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error, depending on the underlying C API
+			 */
+			void toggle(const libperf_event_toggle toggle_type) noexcept(false) ;
+
+			/**
+			 * @brief read - method reads every group and computes the metrics
+			 * @note Stub to libperf_metrics_read()
+			 * @param double *const values - array of LIBPERF_METRIC_COUNT entries, indexed by libperf_metric; metrics unavailable, or not yet run, are NaN
+			 * @throws std::system_error - thrown if counters couldn't be read
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error, depending on the underlying C API
+			 */
+			void read(double *const values) noexcept(false) ;
+
+			/**
+			 * @brief ~Metrics - closes every group
+			 * @note Stub to libperf_metrics_fini()
+			 */
+			~Metrics() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_METRICS_HPP
@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_monitor.h"
+
+/**
+ * @brief Definitions of libperf background monitoring API and inner functionality
+ * @author Salih MSA
+ */
+
+#define LIBPERF_MONITOR_CACHE_LINE 64 // keeps producer & consumer indices from sharing a cache line
+
+struct libperf_monitor { /* lib struct */
+	/* written by producer (monitor thread) */
+	uint64_t head __attribute__((aligned(LIBPERF_MONITOR_CACHE_LINE))); // samples written
+	uint64_t dropped; // samples discarded as ring buffer was full
+	uint64_t failed; // reads which didn't succeed
+
+	/* written by consumer (draining thread) */
+	uint64_t tail __attribute__((aligned(LIBPERF_MONITOR_CACHE_LINE))); // samples drained
+
+	/* fixed once started */
+	libperf_tracker *pd __attribute__((aligned(LIBPERF_MONITOR_CACHE_LINE)));
+	uint64_t interval; // nanoseconds between reads
+	uint64_t capacity; // a power of two
+	struct libperf_monitor_sample *samples; // ring buffer
+	pthread_t thread;
+	int stop; // set to ask monitor thread to exit
+};
+
+static inline uint64_t libperf_monitor_clock(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * UINT64_C(1000000000)) + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief libperf_monitor_run - body of monitor thread
+ * @param void *const arg - monitor
+ * @return void* - NULL
+ */
+static void *libperf_monitor_run(void *const arg)
+{
+	libperf_monitor *const monitor = arg;
+
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	while (!__atomic_load_n(&monitor->stop, __ATOMIC_RELAXED)) {
+		/* wake at absolute deadlines, so time spent reading doesn't make the interval drift */
+		next.tv_nsec += (long)(monitor->interval % UINT64_C(1000000000));
+		next.tv_sec += (time_t)(monitor->interval / UINT64_C(1000000000));
+		if (next.tv_nsec >= 1000000000L) {
+			next.tv_nsec -= 1000000000L;
+			++next.tv_sec;
+		}
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR);
+
+		const uint64_t head = monitor->head; // only this thread writes head
+		if (head - __atomic_load_n(&monitor->tail, __ATOMIC_ACQUIRE) == monitor->capacity) { // acquire pairs with consumer's release, so its copies out of the slot are done
+			__atomic_store_n(&monitor->dropped, monitor->dropped + 1, __ATOMIC_RELAXED);
+			continue;
+		}
+
+		struct libperf_monitor_sample *const sample = &monitor->samples[head & (monitor->capacity - 1)];
+		if (libperf_read_enabled(monitor->pd, &sample->events, sample->values) != LIBPERF_EXIT_SUCCESS) {
+			__atomic_store_n(&monitor->failed, monitor->failed + 1, __ATOMIC_RELAXED);
+			continue;
+		}
+		sample->timestamp = libperf_monitor_clock();
+
+		__atomic_store_n(&monitor->head, head + 1, __ATOMIC_RELEASE); // publish sample; release pairs with consumer's acquire of head
+	}
+
+	return NULL;
+}
+
+libperf_monitor *libperf_monitor_start(libperf_tracker *const pd, const uint64_t interval, const size_t capacity)
+{
+	if (pd == NULL || interval == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid tracker, interval or capacity supplied", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (libperf_get_read_mode(pd) != LIBPERF_READ_MODE_SYSCALL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): monitored trackers must be read with syscalls", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	libperf_monitor *monitor;
+	if (posix_memalign((void **)&monitor, LIBPERF_MONITOR_CACHE_LINE, sizeof(libperf_monitor)) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", __func__);
+		errno = ENOMEM;
+		return NULL;
+	}
+	memset(monitor, 0, sizeof(libperf_monitor));
+
+	monitor->samples = malloc(capacity * sizeof(struct libperf_monitor_sample));
+	if (monitor->samples == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for ring buffer", __func__);
+		free(monitor);
+		return NULL;
+	}
+	monitor->pd = pd;
+	monitor->interval = interval;
+	monitor->capacity = capacity;
+
+	/* monitor thread inherits a fully blocked signal mask, so the application's handlers never run on it */
+	sigset_t all, previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &previous);
+	const int err = pthread_create(&monitor->thread, NULL, libperf_monitor_run, monitor);
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+	if (err != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to create monitor thread", __func__);
+		free(monitor->samples);
+		free(monitor);
+		errno = err;
+		return NULL;
+	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): monitor started", __func__);
+	return monitor;
+}
+
+size_t libperf_monitor_drain(libperf_monitor *const monitor, struct libperf_monitor_sample *const samples, const size_t max)
+{
+	if (monitor == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	const uint64_t tail = monitor->tail; // only the consumer writes tail
+	const uint64_t head = __atomic_load_n(&monitor->head, __ATOMIC_ACQUIRE); // acquire pairs with producer's release, so samples up to head are complete
+	const uint64_t available = head - tail;
+	const size_t count = available < max ? (size_t)available : max;
+
+	for (size_t i = 0; i < count; ++i) {
+		samples[i] = monitor->samples[(tail + i) & (monitor->capacity - 1)];
+	}
+
+	__atomic_store_n(&monitor->tail, tail + count, __ATOMIC_RELEASE); // hand slots back; release pairs with producer's acquire of tail
+
+	return count;
+}
+
+uint64_t libperf_monitor_dropped(const libperf_monitor *const monitor)
+{
+	if (monitor == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return __atomic_load_n(&monitor->dropped, __ATOMIC_RELAXED);
+}
+
+uint64_t libperf_monitor_failed(const libperf_monitor *const monitor)
+{
+	if (monitor == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return __atomic_load_n(&monitor->failed, __ATOMIC_RELAXED);
+}
+
+void libperf_monitor_stop(libperf_monitor *const monitor)
+{
+	if (monitor == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return;
+	}
+
+	__atomic_store_n(&monitor->stop, 1, __ATOMIC_RELAXED);
+	pthread_join(monitor->thread, NULL);
+
+	free(monitor->samples);
+	free(monitor);
+
+	libperf_diag(LOG_NOTICE, "libperf (in %s): monitor stopped", __func__);
+}
@@ -0,0 +1,68 @@
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_monitor.h"
+
+#include "libperf.hpp"
+#include "libperf_monitor.hpp"
+
+/**
+ * @brief Definitions of libperf background monitoring API in C++
+ * @author Salih MSA
+ */
+
+libperf::Monitor::Monitor(libperf::Tracker& tracker, const std::uint64_t interval, const std::size_t capacity) noexcept(false)
+{
+	this->_monitor = libperf_monitor_start(tracker.handle(), interval, capacity) ;
+	if(this->_monitor == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Monitor::Monitor(libperf::Monitor&& monitor) noexcept
+{
+	this->_monitor = monitor._monitor ;
+	monitor._monitor = nullptr ;
+}
+
+libperf::Monitor& libperf::Monitor::operator=(libperf::Monitor&& monitor) noexcept
+{
+	if(this != &monitor)
+	{
+		if(this->_monitor != nullptr)
+		{
+			libperf_monitor_stop(this->_monitor) ;
+		}
+		this->_monitor = monitor._monitor ;
+		monitor._monitor = nullptr ;
+	}
+
+	return *this ;
+}
+
+std::size_t libperf::Monitor::drain(libperf_monitor_sample *const samples, const std::size_t max) noexcept
+{
+	return libperf_monitor_drain(this->_monitor, samples, max) ;
+}
+
+std::uint64_t libperf::Monitor::dropped() const noexcept
+{
+	return libperf_monitor_dropped(this->_monitor) ;
+}
+
+std::uint64_t libperf::Monitor::failed() const noexcept
+{
+	return libperf_monitor_failed(this->_monitor) ;
+}
+
+libperf::Monitor::~Monitor() noexcept
+{
+	if(this->_monitor != nullptr)
+	{
+		libperf_monitor_stop(this->_monitor) ;
+	}
+}
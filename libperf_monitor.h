@@ -0,0 +1,81 @@
+#ifndef LIBPERF_MONITOR_H
+#define LIBPERF_MONITOR_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf background monitoring API
+ * @note A monitor owns a thread which reads a tracker's enabled counters at a fixed interval into a single-producer/single-consumer ring buffer, which another thread drains without locking. Nothing runs on the monitored threads themselves
+ * @author Salih MSA
+ */
+
+struct libperf_monitor;
+typedef struct libperf_monitor libperf_monitor;
+
+struct libperf_monitor_sample { /* counters at a point in time */
+	uint64_t timestamp; // CLOCK_MONOTONIC, in nanoseconds
+	uint64_t events; // mask (see LIBPERF_EVENT_MASK) of counters which were read
+	uint64_t values[LIBPERF_EVENT_SLOTS]; // raw values indexed by enum libperf_event, valid if in events
+};
+
+/**
+ * @brief libperf_monitor_start - function starts a thread reading a tracker periodically
+ * @note Reads are performed with libperf_read_enabled(), so counters enabled (or disabled) later are picked up (or left out) as they change
+ * @pre Tracker must use LIBPERF_READ_MODE_SYSCALL (see libperf_set_read_mode()), as userspace reads only work on the monitored thread itself
+ * @pre libperf_fini() must not be called on the tracker until the monitor is stopped
+ * @note The monitor thread is a child of the calling thread, so counters which inherit will count its reads too; initialise with LIBPERF_INIT_NO_INHERIT to leave it out
+ * @param libperf_tracker *const pd - library structure obtained from libperf_initialise()
+ * @param const uint64_t interval - time between reads, in nanoseconds
+ * @param const size_t capacity - number of samples the ring buffer holds; must be a power of two. When full, new samples are dropped (see libperf_monitor_dropped())
+ * @return libperf_monitor* - handle for use in future library calls
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_monitor *libperf_monitor_start(libperf_tracker *const pd, const uint64_t interval, const size_t capacity);
+
+/**
+ * @brief libperf_monitor_drain - function takes samples out of the ring buffer, oldest first
+ * @note Only one thread may drain a monitor at a time, though it needn't be the same thread each time
+ * @param libperf_monitor *const monitor - handle obtained from libperf_monitor_start()
+ * @param struct libperf_monitor_sample *const samples - array to write samples out to
+ * @param const size_t max - size of array
+ * @return size_t - number of samples written out; 0 if the ring buffer is empty or the handle is invalid
+ */
+size_t libperf_monitor_drain(libperf_monitor *const monitor, struct libperf_monitor_sample *const samples, const size_t max);
+
+/**
+ * @brief libperf_monitor_dropped - function obtains how many samples were discarded as the ring buffer was full
+ * @param const libperf_monitor *const monitor - handle obtained from libperf_monitor_start()
+ * @return uint64_t - number of samples dropped
+ */
+uint64_t libperf_monitor_dropped(const libperf_monitor *const monitor);
+
+/**
+ * @brief libperf_monitor_failed - function obtains how many reads of the tracker failed, and so weren't sampled
+ * @param const libperf_monitor *const monitor - handle obtained from libperf_monitor_start()
+ * @return uint64_t - number of reads failed
+ */
+uint64_t libperf_monitor_failed(const libperf_monitor *const monitor);
+
+/**
+ * @brief libperf_monitor_stop - function stops & joins the monitor thread, freeing any samples not drained
+ * @note Blocks for up to one interval
+ * @param libperf_monitor *const monitor - handle obtained from libperf_monitor_start()
+ */
+void libperf_monitor_stop(libperf_monitor *const monitor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_MONITOR_H
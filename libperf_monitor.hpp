@@ -0,0 +1,87 @@
+#ifndef LIBPERF_MONITOR_HPP
+#define LIBPERF_MONITOR_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "libperf.hpp"
+#include "libperf_monitor.h"
+
+/**
+ * @brief Declarations of libperf background monitoring API for C++
+ * @note Access to monitors in C++ in via an RAII-complaint container
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	class Monitor {
+		private:
+			libperf_monitor* _monitor ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief Monitor (constructor) - starts a thread reading a tracker periodically
+			 * @note Stub to libperf_monitor_start()
+			 * @pre tracker must use libperf_read_mode::LIBPERF_READ_MODE_SYSCALL, and outlive the monitor
+			 * @param Tracker& tracker - tracker to read
+			 * @param const std::uint64_t interval - time between reads, in nanoseconds
+			 * @param const std::size_t capacity - number of samples the ring buffer holds; must be a power of two
+			 * @throws std::system_error - thrown if the monitor couldn't be started, with the errno which caused it
+			 */
+			explicit Monitor(Tracker& tracker, const std::uint64_t interval, const std::size_t capacity) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as there's one monitor thread
+			 */
+			Monitor(const Monitor& monitor) noexcept(false) = delete ;
+			Monitor& operator=(const Monitor& monitor) noexcept(false) = delete ;
+
+			/**
+			 * @brief Monitor (move constructor) - acquire existing monitor
+			 * @param Monitor&& monitor - monitor to acquire
+			 */
+			explicit Monitor(Monitor&& monitor) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing monitor, stopping the one held
+			 * @param Monitor&& monitor - monitor to acquire
+			 * @return Monitor& - object which acquired
+			 */
+			Monitor& operator=(Monitor&& monitor) noexcept ;
+
+			/**
+			 * @brief drain - method takes samples out of the ring buffer, oldest first
+			 * @note Stub to libperf_monitor_drain(). Only one thread may drain at a time
+			 * @param libperf_monitor_sample *const samples - array to write samples out to
+			 * @param const std::size_t max - size of array
+			 * @return std::size_t - number of samples written out
+			 */
+			std::size_t drain(libperf_monitor_sample *const samples, const std::size_t max) noexcept ;
+
+			/**
+			 * @brief dropped - method obtains how many samples were discarded as the ring buffer was full
+			 * @note Stub to libperf_monitor_dropped()
+			 * @return std::uint64_t - number of samples dropped
+			 */
+			std::uint64_t dropped() const noexcept ;
+
+			/**
+			 * @brief failed - method obtains how many reads of the tracker failed
+			 * @note Stub to libperf_monitor_failed()
+			 * @return std::uint64_t - number of reads failed
+			 */
+			std::uint64_t failed() const noexcept ;
+
+			/**
+			 * @brief ~Monitor - stops & joins the monitor thread
+			 * @note Stub to libperf_monitor_stop()
+			 */
+			~Monitor() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_MONITOR_HPP
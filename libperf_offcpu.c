@@ -0,0 +1,256 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <errno.h>
+#include <sys/types.h>
+
+#include <linux/perf_event.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_sampler.h"
+#include "libperf_offcpu.h"
+
+/**
+ * @brief Definitions of libperf off-CPU analysis API and inner functionality
+ * @author Salih MSA
+ */
+
+#define LIBPERF_OFFCPU_SAMPLE_ID (sizeof(uint32_t) * 2 + sizeof(uint64_t)) // trailer of every record, as PERF_SAMPLE_TID | PERF_SAMPLE_TIME: { u32 pid, tid; u64 time; }
+
+struct libperf_offcpu_entry { /* thread being tracked */
+	struct libperf_offcpu_thread stats;
+	uint64_t out; // when thread was switched out
+	bool used; // whether entry is taken
+	bool off; // whether thread is off-CPU, ie out is valid
+	bool preempted; // whether thread was preempted when switched out
+};
+
+struct libperf_offcpu { /* lib struct */
+	libperf_sampler *sampler; // dummy event recording switches
+	struct libperf_offcpu_stats stats;
+	struct libperf_offcpu_entry threads[LIBPERF_OFFCPU_THREADS]; // open addressed by tid
+	size_t tracked; // entries used
+};
+
+/**
+ * @brief libperf_offcpu_lookup - finds the entry of a thread, taking one if it's new
+ * @param libperf_offcpu *const po - handle
+ * @param const uint32_t pid - process ID
+ * @param const uint32_t tid - thread ID
+ * @return struct libperf_offcpu_entry* - entry, or NULL if the thread is new and the table full
+ */
+static struct libperf_offcpu_entry *libperf_offcpu_lookup(libperf_offcpu *const po, const uint32_t pid, const uint32_t tid)
+{
+	size_t slot = (size_t)((tid * UINT64_C(2654435761)) % LIBPERF_OFFCPU_THREADS); // Knuth's multiplicative hash
+	for (size_t probes = 0; probes < LIBPERF_OFFCPU_THREADS; ++probes) {
+		struct libperf_offcpu_entry *const entry = &po->threads[slot];
+		if (entry->used && entry->stats.tid == tid) {
+			return entry;
+		} else if (!entry->used) {
+			if (po->tracked == LIBPERF_OFFCPU_THREADS) {
+				return NULL;
+			}
+			++po->tracked;
+			entry->used = true;
+			entry->stats.pid = pid;
+			entry->stats.tid = tid;
+			return entry;
+		}
+		slot = (slot + 1) % LIBPERF_OFFCPU_THREADS;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief libperf_offcpu_bucket - obtains the histogram bucket of a duration
+ * @param const uint64_t duration - duration in nanoseconds
+ * @return size_t - bucket, ie floor(log2(duration)) capped to the last
+ */
+static inline size_t libperf_offcpu_bucket(const uint64_t duration)
+{
+	const size_t bucket = duration == 0 ? 0 : (size_t)(63 - __builtin_clzll(duration));
+	return bucket < LIBPERF_OFFCPU_BUCKETS ? bucket : LIBPERF_OFFCPU_BUCKETS - 1;
+}
+
+libperf_offcpu *libperf_offcpu_init(const pid_t id, const int cpu, const size_t pages)
+{
+	libperf_offcpu *po = calloc(1, sizeof(libperf_offcpu));
+	if (po == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", __func__);
+		return NULL;
+	}
+
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(struct perf_event_attr));
+	attr.size = sizeof(struct perf_event_attr);
+	attr.type = PERF_TYPE_SOFTWARE;
+	attr.config = PERF_COUNT_SW_DUMMY; // counts nothing, only there to carry side band records
+	attr.context_switch = 1;
+	attr.sample_id_all = 1;
+	attr.sample_type = PERF_SAMPLE_TID | PERF_SAMPLE_TIME;
+	attr.use_clockid = 1; // so intervals line up with the caller's own timestamps
+	attr.clockid = CLOCK_MONOTONIC;
+	attr.disabled = 1; // specifics: as with other samplers, disabled by default
+	if (id != -1) { // as with counters, stick to userspace unless doing system wide analysis
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+	}
+
+	po->sampler = libperf_sampler_init_attr(id, cpu, &attr, pages);
+	if (po->sampler == NULL) {
+		const int err = errno;
+		free(po);
+		errno = err;
+		return NULL;
+	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): off-CPU analysis initialised", __func__);
+	return po;
+}
+
+enum libperf_exit libperf_offcpu_toggle(libperf_offcpu *const po, const enum libperf_event_toggle toggle_type)
+{
+	if (po == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (toggle_type == LIBPERF_EVENT_TOGGLE_RESET) {
+		while (libperf_sampler_next(po->sampler) != NULL); // discard records not yet polled
+		memset(&po->stats, 0, sizeof(struct libperf_offcpu_stats));
+		memset(po->threads, 0, sizeof(po->threads));
+		po->tracked = 0;
+	}
+
+	return libperf_sampler_toggle(po->sampler, toggle_type);
+}
+
+size_t libperf_offcpu_poll(libperf_offcpu *const po, struct libperf_offcpu_interval *const intervals, const size_t max)
+{
+	if (po == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	size_t count = 0;
+	const struct perf_event_header *record;
+	while ((intervals == NULL || count < max) && (record = libperf_sampler_next(po->sampler)) != NULL) {
+		if ((record->type != PERF_RECORD_SWITCH && record->type != PERF_RECORD_SWITCH_CPU_WIDE) || record->size < sizeof(struct perf_event_header) + LIBPERF_OFFCPU_SAMPLE_ID) {
+			continue;
+		}
+
+		/* trailer identifies whoever is switching: the outgoing thread on a switch out, the incoming one on a switch in */
+		const unsigned char *const trailer = (const unsigned char *)record + record->size - LIBPERF_OFFCPU_SAMPLE_ID;
+		uint32_t ids[2];
+		uint64_t time;
+		memcpy(ids, trailer, sizeof(ids));
+		memcpy(&time, trailer + sizeof(ids), sizeof(time));
+
+		struct libperf_offcpu_entry *const entry = libperf_offcpu_lookup(po, ids[0], ids[1]);
+		if (entry == NULL) {
+			continue;
+		}
+
+		if (record->misc & PERF_RECORD_MISC_SWITCH_OUT) {
+			entry->off = true;
+			entry->out = time;
+			entry->preempted = (record->misc & PERF_RECORD_MISC_SWITCH_OUT_PREEMPT) != 0;
+			continue;
+		}
+
+		if (!entry->off) { // switched in without having seen it switched out (e.g. first switch after enabling)
+			continue;
+		}
+		entry->off = false;
+
+		const uint64_t duration = time > entry->out ? time - entry->out : 0;
+
+		po->stats.intervals += 1;
+		po->stats.total_ns += duration;
+		po->stats.histogram[libperf_offcpu_bucket(duration)] += 1;
+		if (duration > po->stats.max_ns) {
+			po->stats.max_ns = duration;
+		}
+
+		entry->stats.intervals += 1;
+		entry->stats.total_ns += duration;
+		if (duration > entry->stats.max_ns) {
+			entry->stats.max_ns = duration;
+		}
+
+		if (entry->preempted) {
+			po->stats.preempted += 1;
+			po->stats.preempted_ns += duration;
+			entry->stats.preempted += 1;
+		}
+
+		if (intervals != NULL) {
+			intervals[count].pid = entry->stats.pid;
+			intervals[count].tid = entry->stats.tid;
+			intervals[count].start = entry->out;
+			intervals[count].end = time;
+			intervals[count].preempted = entry->preempted;
+			++count;
+		}
+	}
+
+	return count;
+}
+
+enum libperf_exit libperf_offcpu_read(const libperf_offcpu *const po, struct libperf_offcpu_stats *const stats)
+{
+	if (po == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	*stats = po->stats;
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+size_t libperf_offcpu_threads(const libperf_offcpu *const po, struct libperf_offcpu_thread *const threads, const size_t max)
+{
+	if (po == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	size_t count = 0;
+	for (size_t i = 0; i < LIBPERF_OFFCPU_THREADS && count < max; ++i) {
+		if (po->threads[i].used) {
+			threads[count++] = po->threads[i].stats;
+		}
+	}
+
+	return count;
+}
+
+uint64_t libperf_offcpu_lost(const libperf_offcpu *const po)
+{
+	if (po == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return libperf_sampler_lost(po->sampler);
+}
+
+void libperf_offcpu_fini(libperf_offcpu *const po)
+{
+	if (po == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return;
+	}
+
+	libperf_sampler_fini(po->sampler);
+	free(po);
+
+	libperf_diag(LOG_NOTICE, "libperf (in %s): off-CPU analysis shut down", __func__);
+}
@@ -0,0 +1,90 @@
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_offcpu.h"
+
+#include "libperf.hpp"
+#include "libperf_offcpu.hpp"
+
+/**
+ * @brief Definitions of libperf off-CPU analysis API in C++
+ * @author Salih MSA
+ */
+
+libperf::OffCpu::OffCpu(const pid_t pid, const int cpu, const std::size_t pages) noexcept(false)
+{
+	this->_offcpu = libperf_offcpu_init(pid, cpu, pages) ;
+	if(this->_offcpu == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::OffCpu::OffCpu(libperf::OffCpu&& offcpu) noexcept
+{
+	this->_offcpu = offcpu._offcpu ;
+	offcpu._offcpu = nullptr ;
+}
+
+libperf::OffCpu& libperf::OffCpu::operator=(libperf::OffCpu&& offcpu) noexcept
+{
+	if(this != &offcpu)
+	{
+		if(this->_offcpu != nullptr)
+		{
+			libperf_offcpu_fini(this->_offcpu) ;
+		}
+		this->_offcpu = offcpu._offcpu ;
+		offcpu._offcpu = nullptr ;
+	}
+
+	return *this ;
+}
+
+void libperf::OffCpu::toggle(const libperf_event_toggle toggle_type) noexcept(false)
+{
+	const auto err = libperf_offcpu_toggle(this->_offcpu, toggle_type) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+std::size_t libperf::OffCpu::poll(libperf_offcpu_interval *const intervals, const std::size_t max) noexcept
+{
+	return libperf_offcpu_poll(this->_offcpu, intervals, max) ;
+}
+
+libperf_offcpu_stats libperf::OffCpu::stats() const noexcept
+{
+	libperf_offcpu_stats stats = {} ;
+	libperf_offcpu_read(this->_offcpu, &stats) ;
+	return stats ;
+}
+
+std::size_t libperf::OffCpu::threads(libperf_offcpu_thread *const threads, const std::size_t max) const noexcept
+{
+	return libperf_offcpu_threads(this->_offcpu, threads, max) ;
+}
+
+std::uint64_t libperf::OffCpu::lost() const noexcept
+{
+	return libperf_offcpu_lost(this->_offcpu) ;
+}
+
+libperf::OffCpu::~OffCpu() noexcept
+{
+	if(this->_offcpu != nullptr)
+	{
+		libperf_offcpu_fini(this->_offcpu) ;
+	}
+}
@@ -0,0 +1,120 @@
+#ifndef LIBPERF_OFFCPU_H
+#define LIBPERF_OFFCPU_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf off-CPU analysis API
+ * @note Whereas LIBPERF_EVENT_SW_CONTEXT_SWITCHES only counts switches, this has the kernel write a record each time a monitored thread is switched out & back in, reconstructing when & for how long each thread was off-CPU, and why: preempted (still runnable) or voluntary (blocked, e.g. on a lock or I/O)
+ * @author Salih MSA
+ */
+
+struct libperf_offcpu;
+typedef struct libperf_offcpu libperf_offcpu;
+
+#define LIBPERF_OFFCPU_BUCKETS 48 // buckets of duration histogram; bucket k holds intervals of [2^k, 2^(k+1)) nanoseconds, the first also 0 & the last everything longer
+#define LIBPERF_OFFCPU_THREADS 1024 // threads which can be tracked
+
+struct libperf_offcpu_interval { /* one stretch of time a thread spent off-CPU */
+	uint32_t pid; // process ID
+	uint32_t tid; // thread ID
+	uint64_t start; // when thread was switched out, in nanoseconds of CLOCK_MONOTONIC
+	uint64_t end; // when thread was switched back in, likewise
+	bool preempted; // whether thread was still runnable (preempted), rather than having blocked
+};
+
+struct libperf_offcpu_stats { /* aggregate of intervals */
+	uint64_t intervals; // number of intervals
+	uint64_t preempted; // of which preempted
+	uint64_t total_ns; // time spent off-CPU
+	uint64_t preempted_ns; // of which preempted
+	uint64_t max_ns; // longest interval
+	uint64_t histogram[LIBPERF_OFFCPU_BUCKETS]; // intervals by duration
+};
+
+struct libperf_offcpu_thread { /* aggregate of one thread's intervals */
+	uint32_t pid; // process ID
+	uint32_t tid; // thread ID
+	uint64_t intervals; // number of intervals
+	uint64_t preempted; // of which preempted
+	uint64_t total_ns; // time spent off-CPU
+	uint64_t max_ns; // longest interval
+};
+
+/**
+ * @brief libperf_offcpu_init - function starts recording context switches
+ * @param const pid_t id - thread ID to monitor (0 for the calling thread); a process ID only monitors its main thread
+ * @note Set -1 for every thread on a CPU (requires privileges)
+ * @param const int cpu - pass in specific cpuid to track
+ * @note Set -1 for all CPUs (not possible with system wide monitoring)
+ * @param const size_t pages - size of ring buffer in pages; must be a power of two. Two records are written per switch, so size it for how often libperf_offcpu_poll() is called
+ * @return libperf_offcpu* - handle for use in future library calls, initially disabled
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_offcpu *libperf_offcpu_init(const pid_t id, const int cpu, const size_t pages);
+
+/**
+ * @brief libperf_offcpu_toggle - function enables or disables recording, bounding the region analysed
+ * @param libperf_offcpu *const po - handle obtained from libperf_offcpu_init()
+ * @param const enum libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET; the latter discards statistics & records not yet polled
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_offcpu_toggle(libperf_offcpu *const po, const enum libperf_event_toggle toggle_type);
+
+/**
+ * @brief libperf_offcpu_poll - function consumes records from the ring buffer, accumulating the intervals they complete into the statistics
+ * @param libperf_offcpu *const po - handle obtained from libperf_offcpu_init()
+ * @param struct libperf_offcpu_interval *const intervals - array to write completed intervals out to, or NULL if only statistics are wanted
+ * @param const size_t max - size of array; once full, the remaining records are left for the next call
+ * @return size_t - number of intervals written out
+ */
+size_t libperf_offcpu_poll(libperf_offcpu *const po, struct libperf_offcpu_interval *const intervals, const size_t max);
+
+/**
+ * @brief libperf_offcpu_read - function obtains statistics of every interval polled so far
+ * @param const libperf_offcpu *const po - handle obtained from libperf_offcpu_init()
+ * @param struct libperf_offcpu_stats *const stats - statistics to write out to
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_offcpu_read(const libperf_offcpu *const po, struct libperf_offcpu_stats *const stats);
+
+/**
+ * @brief libperf_offcpu_threads - function obtains statistics of every interval polled so far, by thread
+ * @note Only the first LIBPERF_OFFCPU_THREADS threads seen are tracked; switches of any others are ignored
+ * @param const libperf_offcpu *const po - handle obtained from libperf_offcpu_init()
+ * @param struct libperf_offcpu_thread *const threads - array to write threads out to
+ * @param const size_t max - size of array
+ * @return size_t - number of threads written out
+ */
+size_t libperf_offcpu_threads(const libperf_offcpu *const po, struct libperf_offcpu_thread *const threads, const size_t max);
+
+/**
+ * @brief libperf_offcpu_lost - function obtains how many records the kernel dropped as the ring buffer was full
+ * @note Intervals whose records were lost are missing from statistics
+ * @param const libperf_offcpu *const po - handle obtained from libperf_offcpu_init()
+ * @return uint64_t - number of records lost
+ */
+uint64_t libperf_offcpu_lost(const libperf_offcpu *const po);
+
+/**
+ * @brief libperf_offcpu_fini - function stops recording context switches
+ * @param libperf_offcpu *const po - handle obtained from libperf_offcpu_init()
+ */
+void libperf_offcpu_fini(libperf_offcpu *const po);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_OFFCPU_H
@@ -0,0 +1,105 @@
+#ifndef LIBPERF_OFFCPU_HPP
+#define LIBPERF_OFFCPU_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+#include "libperf.hpp"
+#include "libperf_offcpu.h"
+
+/**
+ * @brief Declarations of libperf off-CPU analysis API for C++
+ * @note Access to off-CPU analysis in C++ in via an RAII-complaint container
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	class OffCpu {
+		private:
+			libperf_offcpu* _offcpu ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief OffCpu (constructor) - starts recording context switches, initially disabled
+			 * @note Stub to libperf_offcpu_init()
+			 * @param const pid_t pid - thread ID to monitor (0 for the calling thread), or -1 for every thread on a CPU
+			 * @param const int cpu - pass in specific cpuid to track
+			 * @param const std::size_t pages - size of ring buffer in pages; must be a power of two
+			 * @throws std::system_error - thrown if recording couldn't be started, with the errno which caused it
+			 */
+			explicit OffCpu(const pid_t pid, const int cpu, const std::size_t pages) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as there's one ring buffer
+			 */
+			OffCpu(const OffCpu& offcpu) noexcept(false) = delete ;
+			OffCpu& operator=(const OffCpu& offcpu) noexcept(false) = delete ;
+
+			/**
+			 * @brief OffCpu (move constructor) - acquire existing recording
+			 * @param OffCpu&& offcpu - recording to acquire
+			 */
+			explicit OffCpu(OffCpu&& offcpu) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing recording, stopping the one held
+			 * @param OffCpu&& offcpu - recording to acquire
+			 * @return OffCpu& - object which acquired
+			 */
+			OffCpu& operator=(OffCpu&& offcpu) noexcept ;
+
+			/**
+			 * @brief toggle - method enables or disables recording, bounding the region analysed
+			 * @note Stub to libperf_offcpu_toggle()
+			 * @param const libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+			 * @throws std::system_error - thrown if we can't manipulate recording
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error, depending on the underlying C API
+			 */
+			void toggle(const libperf_event_toggle toggle_type) noexcept(false) ;
+
+			/**
+			 * @brief poll - method consumes records, accumulating the intervals they complete into the statistics
+			 * @note Stub to libperf_offcpu_poll()
+			 * @param libperf_offcpu_interval *const intervals - array to write completed intervals out to, or nullptr if only statistics are wanted
+			 * @param const std::size_t max - size of array
+			 * @return std::size_t - number of intervals written out
+			 */
+			std::size_t poll(libperf_offcpu_interval *const intervals = nullptr, const std::size_t max = 0) noexcept ;
+
+			/**
+			 * @brief stats - method obtains statistics of every interval polled so far
+			 * @note Stub to libperf_offcpu_read()
+			 * @return libperf_offcpu_stats - statistics
+			 */
+			libperf_offcpu_stats stats() const noexcept ;
+
+			/**
+			 * @brief threads - method obtains statistics of every interval polled so far, by thread
+			 * @note Stub to libperf_offcpu_threads()
+			 * @param libperf_offcpu_thread *const threads - array to write threads out to
+			 * @param const std::size_t max - size of array
+			 * @return std::size_t - number of threads written out
+			 */
+			std::size_t threads(libperf_offcpu_thread *const threads, const std::size_t max) const noexcept ;
+
+			/**
+			 * @brief lost - method obtains how many records the kernel dropped as the ring buffer was full
+			 * @note Stub to libperf_offcpu_lost()
+			 * @return std::uint64_t - number of records lost
+			 */
+			std::uint64_t lost() const noexcept ;
+
+			/**
+			 * @brief ~OffCpu - stops recording
+			 * @note Stub to libperf_offcpu_fini()
+			 */
+			~OffCpu() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_OFFCPU_HPP
@@ -0,0 +1,601 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dirent.h>
+#include <elf.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <linux/perf_event.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_pmu.h"
+
+/**
+ * @brief Definitions of libperf PMU event parsing API and inner functionality
+ * @author Salih MSA
+ */
+
+#define LIBPERF_PMU_NAME 64 // longest PMU, term or event name
+#define LIBPERF_PMU_FILE 256 // longest contents of a sysfs file read
+#define LIBPERF_PMU_DEPTH 4 // how deeply named events may refer to one another
+#define LIBPERF_PMU_TRACEFS_FALLBACK "/sys/kernel/debug/tracing" // where tracefs lives on older systems
+
+/**
+ * @brief libperf_pmu_name_valid - checks a name taken from a description can safely be made into a sysfs path
+ * @param const char *const name - PMU, term or event name
+ * @return bool - whether it's valid
+ */
+static bool libperf_pmu_name_valid(const char *const name)
+{
+	return name[0] != '\0' && name[0] != '.' && strchr(name, '/') == NULL && strlen(name) < LIBPERF_PMU_NAME;
+}
+
+/**
+ * @brief libperf_pmu_read_file - reads the first line of a (small) sysfs or tracefs file
+ * @param const char *const path - path of file
+ * @param char *const buffer - buffer to read into, its trailing newline stripped
+ * @return bool - whether file was read, errno set otherwise
+ */
+static bool libperf_pmu_read_file(const char *const path, char buffer[LIBPERF_PMU_FILE])
+{
+	FILE *const stream = fopen(path, "r");
+	if (stream == NULL) {
+		return false;
+	}
+
+	const bool read = fgets(buffer, LIBPERF_PMU_FILE, stream) != NULL;
+	fclose(stream);
+	if (!read) {
+		errno = EIO;
+		return false;
+	}
+
+	buffer[strcspn(buffer, "\n")] = '\0';
+	return true;
+}
+
+/**
+ * @brief libperf_pmu_read - reads a (small) sysfs file of a PMU
+ * @param const char *const pmu - PMU name
+ * @param const char *const file - path of file, relative to the PMU's directory
+ * @param char *const buffer - buffer to read into, its trailing newline stripped
+ * @return bool - whether file was read, errno set otherwise
+ */
+static bool libperf_pmu_read(const char *const pmu, const char *const file, char buffer[LIBPERF_PMU_FILE])
+{
+	char path[sizeof(LIBPERF_PMU_SYSFS) + (3 * LIBPERF_PMU_NAME)];
+	snprintf(path, sizeof(path), "%s/%s/%s", LIBPERF_PMU_SYSFS, pmu, file);
+
+	return libperf_pmu_read_file(path, buffer);
+}
+
+/**
+ * @brief libperf_pmu_field - obtains which attribute field a format targets
+ * @param struct perf_event_attr *const attr - attributes
+ * @param const char *const name - field name, as used by format files
+ * @return uint64_t* - field, or NULL if unknown
+ */
+static uint64_t *libperf_pmu_field(struct perf_event_attr *const attr, const char *const name)
+{
+	if (strcmp(name, "config") == 0) {
+		return (uint64_t *)&attr->config;
+	} else if (strcmp(name, "config1") == 0) {
+		return (uint64_t *)&attr->config1;
+	} else if (strcmp(name, "config2") == 0) {
+		return (uint64_t *)&attr->config2;
+	}
+	return NULL;
+}
+
+/**
+ * @brief libperf_pmu_format - places a value into the bits a format (e.g. "config:0-7,21") spans, lowest bits of value first
+ * @param struct perf_event_attr *const attr - attributes to update
+ * @param char *const format - contents of format file (modified)
+ * @param uint64_t value - value of term
+ * @return bool - whether format was understood and value fit
+ */
+static bool libperf_pmu_format(struct perf_event_attr *const attr, char *const format, uint64_t value)
+{
+	char *const colon = strchr(format, ':');
+	if (colon == NULL) {
+		return false;
+	}
+	*colon = '\0';
+
+	uint64_t *const field = libperf_pmu_field(attr, format);
+	if (field == NULL) {
+		return false;
+	}
+
+	char *cursor = colon + 1;
+	while (*cursor != '\0') {
+		char *end;
+		const unsigned long low = strtoul(cursor, &end, 10);
+		unsigned long high = low;
+		if (*end == '-') {
+			high = strtoul(end + 1, &end, 10);
+		}
+		if (end == cursor || high < low || high > 63 || (*end != ',' && *end != '\0')) {
+			return false;
+		}
+
+		const unsigned long width = high - low + 1;
+		const uint64_t mask = width == 64 ? UINT64_MAX : (UINT64_C(1) << width) - 1;
+		*field = (*field & ~(mask << low)) | ((value & mask) << low);
+		value = width == 64 ? 0 : value >> width;
+
+		cursor = *end == ',' ? end + 1 : end;
+	}
+
+	return value == 0; // anything left over didn't fit
+}
+
+static enum libperf_exit libperf_pmu_terms(const char *const pmu, const char *const terms, struct perf_event_attr *const attr, const unsigned depth);
+
+/**
+ * @brief libperf_pmu_term - applies one term of a description
+ * @param const char *const pmu - PMU name
+ * @param const char *const key - term name
+ * @param const char *const value - term value, or NULL if none was given
+ * @param struct perf_event_attr *const attr - attributes to update
+ * @param const unsigned depth - how many named events deep this term is
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static enum libperf_exit libperf_pmu_term(const char *const pmu, const char *const key, const char *const value, struct perf_event_attr *const attr, const unsigned depth)
+{
+	if (!libperf_pmu_name_valid(key)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid term '%s'", __func__, key);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	uint64_t number = 1; // terms without values are flags
+	if (value != NULL) {
+		char *end;
+		errno = 0;
+		number = strtoull(value, &end, 0);
+		if (end == value || *end != '\0' || errno != 0) {
+			libperf_diag(LOG_ERR, "libperf (in %s): invalid value '%s' of term '%s'", __func__, value, key);
+			return LIBPERF_EXIT_COUNTER_INVALID;
+		}
+	}
+
+	uint64_t *const field = libperf_pmu_field(attr, key);
+	if (field != NULL) { // raw config
+		*field = number;
+		return LIBPERF_EXIT_SUCCESS;
+	} else if (strcmp(key, "period") == 0) {
+		attr->sample_period = number;
+		return LIBPERF_EXIT_SUCCESS;
+	} else if (strcmp(key, "name") == 0) { // only meaningful to perf(1)
+		return LIBPERF_EXIT_SUCCESS;
+	}
+
+	char path[LIBPERF_PMU_NAME + sizeof("events/")];
+	char contents[LIBPERF_PMU_FILE];
+
+	snprintf(path, sizeof(path), "format/%s", key);
+	if (libperf_pmu_read(pmu, path, contents)) {
+		if (!libperf_pmu_format(attr, contents, number)) {
+			libperf_diag(LOG_ERR, "libperf (in %s): value of term '%s' doesn't fit its format", __func__, key);
+			return LIBPERF_EXIT_COUNTER_INVALID;
+		}
+		return LIBPERF_EXIT_SUCCESS;
+	}
+
+	snprintf(path, sizeof(path), "events/%s", key);
+	if (value == NULL && libperf_pmu_read(pmu, path, contents)) { // named event, itself a list of terms
+		if (depth == LIBPERF_PMU_DEPTH) {
+			libperf_diag(LOG_ERR, "libperf (in %s): event '%s' nested too deeply", __func__, key);
+			return LIBPERF_EXIT_COUNTER_INVALID;
+		}
+		return libperf_pmu_terms(pmu, contents, attr, depth + 1);
+	}
+
+	libperf_diag(LOG_ERR, "libperf (in %s): PMU '%s' has no term or event '%s'", __func__, pmu, key);
+	return LIBPERF_EXIT_COUNTER_INVALID;
+}
+
+/**
+ * @brief libperf_pmu_terms - applies a comma separated list of terms
+ * @param const char *const pmu - PMU name
+ * @param const char *const terms - list of terms
+ * @param struct perf_event_attr *const attr - attributes to update
+ * @param const unsigned depth - how many named events deep these terms are
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static enum libperf_exit libperf_pmu_terms(const char *const pmu, const char *const terms, struct perf_event_attr *const attr, const unsigned depth)
+{
+	char list[LIBPERF_PMU_FILE];
+	if (strlen(terms) >= sizeof(list)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): list of terms too long", __func__);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+	strcpy(list, terms);
+
+	char *save;
+	for (char *term = strtok_r(list, ",", &save); term != NULL; term = strtok_r(NULL, ",", &save)) {
+		char *const equals = strchr(term, '=');
+		if (equals != NULL) {
+			*equals = '\0';
+		}
+
+		const enum libperf_exit rt = libperf_pmu_term(pmu, term, equals != NULL ? equals + 1 : NULL, attr, depth);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+/**
+ * @brief libperf_pmu_type - reads the type a PMU's events are opened with
+ * @param const char *const pmu - PMU name
+ * @param struct perf_event_attr *const attr - attributes to write type out to
+ * @return bool - whether PMU exists
+ */
+static bool libperf_pmu_type(const char *const pmu, struct perf_event_attr *const attr)
+{
+	char contents[LIBPERF_PMU_FILE];
+	if (!libperf_pmu_name_valid(pmu) || !libperf_pmu_read(pmu, "type", contents)) {
+		return false;
+	}
+
+	attr->type = (uint32_t)strtoul(contents, NULL, 10);
+	return true;
+}
+
+/**
+ * @brief libperf_pmu_find - finds the PMU exporting a named event, trying cpu first
+ * @param const char *const name - event name
+ * @param char *const pmu - buffer to write PMU name out to
+ * @return bool - whether a PMU was found
+ */
+static bool libperf_pmu_find(const char *const name, char pmu[LIBPERF_PMU_NAME])
+{
+	char path[LIBPERF_PMU_NAME + sizeof("events/")];
+	char contents[LIBPERF_PMU_FILE];
+	snprintf(path, sizeof(path), "events/%s", name);
+
+	if (libperf_pmu_read("cpu", path, contents)) {
+		strcpy(pmu, "cpu");
+		return true;
+	}
+
+	DIR *const devices = opendir(LIBPERF_PMU_SYSFS);
+	if (devices == NULL) {
+		return false;
+	}
+
+	bool found = false;
+	for (const struct dirent *entry = readdir(devices); entry != NULL && !found; entry = readdir(devices)) {
+		if (libperf_pmu_name_valid(entry->d_name) && libperf_pmu_read(entry->d_name, path, contents)) {
+			strcpy(pmu, entry->d_name);
+			found = true;
+		}
+	}
+	closedir(devices);
+
+	return found;
+}
+
+/**
+ * @brief libperf_pmu_modifiers - applies modifiers following a description
+ * @param const char *const modifiers - modifiers, e.g. "upp"
+ * @param struct perf_event_attr *const attr - attributes to update
+ * @return bool - whether every modifier was understood
+ */
+static bool libperf_pmu_modifiers(const char *const modifiers, struct perf_event_attr *const attr)
+{
+	bool user = false, kernel = false, hypervisor = false;
+
+	for (const char *modifier = modifiers; *modifier != '\0'; ++modifier) {
+		switch (*modifier) {
+			case 'u':;
+				user = true;
+				break;
+			case 'k':;
+				kernel = true;
+				break;
+			case 'h':;
+				hypervisor = true;
+				break;
+			case 'p':;
+				if (attr->precise_ip == 3) {
+					return false;
+				}
+				++attr->precise_ip;
+				break;
+			default:;
+				return false;
+		}
+	}
+
+	if (user || kernel || hypervisor) { // as with perf(1), naming any privilege level excludes the others
+		attr->exclude_user = !user;
+		attr->exclude_kernel = !kernel;
+		attr->exclude_hv = !hypervisor;
+	}
+
+	return true;
+}
+
+/**
+ * @brief libperf_pmu_tracepoint_id - reads the ID of a tracepoint from tracefs
+ * @param const char *const subsystem - subsystem of tracepoint (e.g. "syscalls")
+ * @param const char *const event - tracepoint within subsystem (e.g. "sys_enter_futex")
+ * @param uint64_t *const id - ID to write out to
+ * @return bool - whether tracepoint exists
+ */
+static bool libperf_pmu_tracepoint_id(const char *const subsystem, const char *const event, uint64_t *const id)
+{
+	if (!libperf_pmu_name_valid(subsystem) || !libperf_pmu_name_valid(event)) {
+		return false;
+	}
+
+	static const char *const roots[] = { LIBPERF_PMU_TRACEFS, LIBPERF_PMU_TRACEFS_FALLBACK };
+	char path[sizeof(LIBPERF_PMU_TRACEFS_FALLBACK) + sizeof(LIBPERF_PMU_TRACEFS) + (2 * LIBPERF_PMU_NAME) + sizeof("/events///id")];
+	char contents[LIBPERF_PMU_FILE];
+
+	for (size_t i = 0; i < sizeof(roots) / sizeof(roots[0]); ++i) {
+		snprintf(path, sizeof(path), "%s/events/%s/%s/id", roots[i], subsystem, event);
+		if (libperf_pmu_read_file(path, contents)) {
+			char *end;
+			*id = strtoull(contents, &end, 10);
+			return end != contents;
+		}
+	}
+
+	return false;
+}
+
+enum libperf_exit libperf_pmu_tracepoint(const char *const name, struct perf_event_attr *const attr)
+{
+	char subsystem[LIBPERF_PMU_NAME];
+	const char *const colon = name != NULL ? strchr(name, ':') : NULL;
+	if (colon == NULL || attr == NULL || (size_t)(colon - name) >= sizeof(subsystem)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid tracepoint supplied, expected 'subsystem:event'", __func__);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+	memcpy(subsystem, name, (size_t)(colon - name));
+	subsystem[colon - name] = '\0';
+
+	uint64_t id;
+	if (!libperf_pmu_tracepoint_id(subsystem, colon + 1, &id)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): tracepoint '%s' not found; is tracefs mounted & readable?", __func__, name);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	memset(attr, 0, sizeof(struct perf_event_attr));
+	attr->size = sizeof(struct perf_event_attr);
+	attr->type = PERF_TYPE_TRACEPOINT;
+	attr->config = id;
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+/**
+ * @brief libperf_pmu_elf_symbol - looks a function up in the symbol tables of a mapped ELF file, translating its address into a file offset
+ * @param const unsigned char *const image - file contents
+ * @param const size_t size - size of file
+ * @param const char *const symbol - function name
+ * @param uint64_t *const offset - offset to write out to
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static enum libperf_exit libperf_pmu_elf_symbol(const unsigned char *const image, const size_t size, const char *const symbol, uint64_t *const offset)
+{
+	if (size < sizeof(Elf64_Ehdr) || memcmp(image, ELFMAG, SELFMAG) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): not an ELF file", __func__);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+	if (image[EI_CLASS] != ELFCLASS64 || image[EI_DATA] != ELFDATA2LSB) {
+		libperf_diag(LOG_ERR, "libperf (in %s): only 64 bit little endian ELF files are supported", __func__);
+		return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+
+	const Elf64_Ehdr *const header = (const Elf64_Ehdr *)image;
+	if (header->e_shentsize != sizeof(Elf64_Shdr) || header->e_shoff > size || header->e_shnum > (size - header->e_shoff) / sizeof(Elf64_Shdr)
+		|| header->e_phentsize != sizeof(Elf64_Phdr) || header->e_phoff > size || header->e_phnum > (size - header->e_phoff) / sizeof(Elf64_Phdr)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): malformed ELF file", __func__);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+	const Elf64_Shdr *const sections = (const Elf64_Shdr *)(image + header->e_shoff);
+	const Elf64_Phdr *const segments = (const Elf64_Phdr *)(image + header->e_phoff);
+
+	/* symtab is the more complete, but stripped files only have dynsym */
+	const Elf64_Word tables[] = { SHT_SYMTAB, SHT_DYNSYM };
+	for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); ++t) {
+		for (size_t s = 0; s < header->e_shnum; ++s) {
+			const Elf64_Shdr *const table = &sections[s];
+			if (table->sh_type != tables[t] || table->sh_link >= header->e_shnum || table->sh_entsize != sizeof(Elf64_Sym)
+				|| table->sh_offset > size || table->sh_size > size - table->sh_offset) {
+				continue;
+			}
+			const Elf64_Shdr *const strings = &sections[table->sh_link];
+			if (strings->sh_offset > size || strings->sh_size > size - strings->sh_offset) {
+				continue;
+			}
+
+			const Elf64_Sym *const symbols = (const Elf64_Sym *)(image + table->sh_offset);
+			const char *const names = (const char *)(image + strings->sh_offset);
+			const size_t name_length = strlen(symbol);
+			for (size_t i = 0; i < table->sh_size / sizeof(Elf64_Sym); ++i) {
+				const Elf64_Sym *const entry = &symbols[i];
+				if (ELF64_ST_TYPE(entry->st_info) != STT_FUNC || entry->st_shndx == SHN_UNDEF || entry->st_name >= strings->sh_size
+					|| strings->sh_size - entry->st_name <= name_length || memcmp(names + entry->st_name, symbol, name_length + 1) != 0) {
+					continue;
+				}
+
+				for (size_t p = 0; p < header->e_phnum; ++p) { // uprobes are placed by file offset, so find the segment mapping the function
+					const Elf64_Phdr *const segment = &segments[p];
+					if (segment->p_type == PT_LOAD && (segment->p_flags & PF_X) && entry->st_value >= segment->p_vaddr && entry->st_value < segment->p_vaddr + segment->p_filesz) {
+						*offset = entry->st_value - segment->p_vaddr + segment->p_offset;
+						return LIBPERF_EXIT_SUCCESS;
+					}
+				}
+			}
+		}
+	}
+
+	libperf_diag(LOG_ERR, "libperf (in %s): function '%s' not found", __func__, symbol);
+	return LIBPERF_EXIT_COUNTER_INVALID;
+}
+
+enum libperf_exit libperf_pmu_uprobe(const char *const path, const char *const symbol, const bool retprobe, struct perf_event_attr *const attr)
+{
+	if (path == NULL || symbol == NULL || attr == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid uprobe supplied", __func__);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	memset(attr, 0, sizeof(struct perf_event_attr));
+	attr->size = sizeof(struct perf_event_attr);
+
+	if (!libperf_pmu_type("uprobe", attr)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): kernel has no uprobe PMU", __func__);
+		return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+
+	if (retprobe) {
+		char format[LIBPERF_PMU_FILE];
+		if (!libperf_pmu_read("uprobe", "format/retprobe", format) || !libperf_pmu_format(attr, format, 1)) {
+			libperf_diag(LOG_ERR, "libperf (in %s): kernel doesn't support uretprobes", __func__);
+			return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+		}
+	}
+
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to open '%s'", __func__, path);
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	struct stat status;
+	const bool inspected = fstat(fd, &status) == 0;
+	if (!inspected || status.st_size <= 0) {
+		const int err = inspected ? ENOEXEC : errno;
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to inspect '%s'", __func__, path);
+		close(fd);
+		errno = err;
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	void *const image = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	const int err = errno;
+	close(fd);
+	if (image == MAP_FAILED) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to map '%s'", __func__, path);
+		errno = err;
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	uint64_t offset = 0;
+	const enum libperf_exit rt = libperf_pmu_elf_symbol(image, (size_t)status.st_size, symbol, &offset);
+	munmap(image, (size_t)status.st_size);
+	if (rt != LIBPERF_EXIT_SUCCESS) {
+		return rt;
+	}
+
+	attr->config1 = (uint64_t)(uintptr_t)path; // uprobe_path, read by the kernel when the event is opened
+	attr->config2 = offset; // probe_offset
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_pmu_parse(const char *const spec, struct perf_event_attr *const attr)
+{
+	if (spec == NULL || attr == NULL || strlen(spec) >= LIBPERF_PMU_FILE) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid event description supplied", __func__);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	memset(attr, 0, sizeof(struct perf_event_attr));
+	attr->size = sizeof(struct perf_event_attr);
+
+	char description[LIBPERF_PMU_FILE];
+	strcpy(description, spec);
+
+	char pmu[LIBPERF_PMU_NAME];
+	const char *terms;
+	const char *modifiers = "";
+
+	char *const slash = strchr(description, '/');
+	if (slash != NULL) { // pmu/terms/[:modifiers]
+		char *const closing = strrchr(description, '/');
+		if (closing == slash || (closing[1] != '\0' && closing[1] != ':')) {
+			libperf_diag(LOG_ERR, "libperf (in %s): malformed event description '%s'", __func__, spec);
+			return LIBPERF_EXIT_COUNTER_INVALID;
+		}
+		if (closing[1] == ':') {
+			modifiers = closing + 2;
+		}
+		*slash = '\0';
+		*closing = '\0';
+
+		if (strlen(description) >= sizeof(pmu)) {
+			libperf_diag(LOG_ERR, "libperf (in %s): PMU '%s' unknown", __func__, description);
+			return LIBPERF_EXIT_COUNTER_INVALID;
+		}
+		strcpy(pmu, description);
+		terms = slash + 1;
+	} else { // name[:modifiers], or subsystem:tracepoint[:modifiers]
+		char *const colon = strchr(description, ':');
+		if (colon != NULL) {
+			*colon = '\0';
+			modifiers = colon + 1;
+
+			char *const second = strchr(modifiers, ':');
+			if (second != NULL) {
+				*second = '\0';
+			}
+			uint64_t id;
+			if (libperf_pmu_tracepoint_id(description, modifiers, &id)) {
+				attr->type = PERF_TYPE_TRACEPOINT;
+				attr->config = id;
+				modifiers = second != NULL ? second + 1 : "";
+				if (!libperf_pmu_modifiers(modifiers, attr)) {
+					libperf_diag(LOG_ERR, "libperf (in %s): invalid modifiers '%s'", __func__, modifiers);
+					return LIBPERF_EXIT_COUNTER_INVALID;
+				}
+				return LIBPERF_EXIT_SUCCESS;
+			}
+			if (second != NULL) { // not a tracepoint after all, so all of it are modifiers
+				*second = ':';
+			}
+		}
+
+		if (!libperf_pmu_name_valid(description) || !libperf_pmu_find(description, pmu)) {
+			libperf_diag(LOG_ERR, "libperf (in %s): no PMU has an event named '%s'", __func__, description);
+			return LIBPERF_EXIT_COUNTER_INVALID;
+		}
+		terms = description;
+	}
+
+	if (!libperf_pmu_type(pmu, attr)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): PMU '%s' unknown", __func__, pmu);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	const enum libperf_exit rt = libperf_pmu_terms(pmu, terms, attr, 0);
+	if (rt != LIBPERF_EXIT_SUCCESS) {
+		return rt;
+	}
+
+	if (!libperf_pmu_modifiers(modifiers, attr)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid modifiers '%s'", __func__, modifiers);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_pmu.h"
+
+#include "libperf.hpp"
+#include "libperf_pmu.hpp"
+
+/**
+ * @brief Definitions of libperf PMU event parsing API in C++
+ * @author Salih MSA
+ */
+
+perf_event_attr libperf::pmu_parse(const char *const spec) noexcept(false)
+{
+	perf_event_attr attr ;
+
+	const auto err = libperf_pmu_parse(spec, &attr) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+
+	return attr ;
+}
+
+perf_event_attr libperf::pmu_tracepoint(const char *const name) noexcept(false)
+{
+	perf_event_attr attr ;
+
+	const auto err = libperf_pmu_tracepoint(name, &attr) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+
+	return attr ;
+}
+
+perf_event_attr libperf::pmu_uprobe(const char *const path, const char *const symbol, const bool retprobe) noexcept(false)
+{
+	perf_event_attr attr ;
+
+	const auto err = libperf_pmu_uprobe(path, symbol, retprobe, &attr) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+
+	return attr ;
+}
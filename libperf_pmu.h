@@ -0,0 +1,70 @@
+#ifndef LIBPERF_PMU_H
+#define LIBPERF_PMU_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <linux/perf_event.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf PMU event parsing API
+ * @note Resolves events the way perf(1) names them, using what each PMU exports under /sys/bus/event_source/devices/<pmu>: its type, the format of its config fields (format/) and its named events (events/)
+ * @author Salih MSA
+ */
+
+#ifndef LIBPERF_PMU_SYSFS
+#define LIBPERF_PMU_SYSFS "/sys/bus/event_source/devices" // where PMUs are described
+#endif
+
+#ifndef LIBPERF_PMU_TRACEFS
+#define LIBPERF_PMU_TRACEFS "/sys/kernel/tracing" // where tracepoints are described; /sys/kernel/debug/tracing is tried too
+#endif
+
+/**
+ * @brief libperf_pmu_parse - function translates an event description into attributes, for use with libperf_init_explicit()
+ * @note Accepted forms are:
+ * - `pmu/term[=value],.../` - terms are fields of the PMU's format (e.g. `cpu/event=0xd1,umask=0x20/`; a field without a value is set to 1), its named events (e.g. `cpu/topdown-be-bound/`), or config, config1, config2 & period directly
+ * - `name` - a named event, looked up in the `cpu` PMU first and then every other (e.g. `topdown-be-bound`)
+ * - `subsystem:tracepoint` - a tracepoint, see libperf_pmu_tracepoint() (e.g. `sched:sched_switch`)
+ * @note Either form may be followed by `:` and modifiers: u (userspace only), k (kernel only), h (hypervisor only), p (precise, repeatable up to 3 times)
+ * @param const char *const spec - description of event
+ * @param struct perf_event_attr *const attr - attributes to write out to; only type, config*, sample_period, exclude_* & precise_ip are set, the rest zeroed
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_COUNTER_INVALID if the PMU, a term or event is unknown, or the description is malformed
+ */
+enum libperf_exit libperf_pmu_parse(const char *const spec, struct perf_event_attr *const attr);
+
+/**
+ * @brief libperf_pmu_tracepoint - function resolves a tracepoint by name into attributes, for use with libperf_init_explicit()
+ * @note IDs are read from tracefs (LIBPERF_PMU_TRACEFS), which must be mounted & readable. Tracepoints fire in the kernel, so leave exclude_kernel unset (e.g. sched:sched_switch would otherwise never count); syscalls:* fire on behalf of userspace, so count either way
+ * @param const char *const name - tracepoint, as `subsystem:event` (e.g. `syscalls:sys_enter_futex`)
+ * @param struct perf_event_attr *const attr - attributes to write out to; only type & config are set, the rest zeroed
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_COUNTER_INVALID if the tracepoint doesn't exist or tracefs couldn't be read
+ */
+enum libperf_exit libperf_pmu_tracepoint(const char *const name, struct perf_event_attr *const attr);
+
+/**
+ * @brief libperf_pmu_uprobe - function creates the attributes of a dynamic uprobe on entry to (or return from) a function of a binary, for use with libperf_init_explicit()
+ * @note The function is looked up in the ELF symbol table (falling back to the dynamic one), so it needn't be exported; only 64 bit little endian ELF files are supported. Counts every call, by any thread of a monitored process, without recompiling
+ * @param const char *const path - path of executable or shared library (e.g. "/lib/x86_64-linux-gnu/libc.so.6"); attributes refer to it, so it must outlive the call to libperf_init_explicit()
+ * @param const char *const symbol - function name, as it appears in the symbol table (ie mangled for C++)
+ * @param const bool retprobe - whether to count returns from the function rather than entries
+ * @param struct perf_event_attr *const attr - attributes to write out to; only type & config* are set, the rest zeroed
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_SYSTEM_ERROR if the binary couldn't be read (errno set), LIBPERF_EXIT_COUNTER_INVALID if the function wasn't found, LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED if the kernel lacks uprobes
+ */
+enum libperf_exit libperf_pmu_uprobe(const char *const path, const char *const symbol, const bool retprobe, struct perf_event_attr *const attr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_PMU_H
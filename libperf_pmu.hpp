@@ -0,0 +1,49 @@
+#ifndef LIBPERF_PMU_HPP
+#define LIBPERF_PMU_HPP
+#pragma once
+
+#include "libperf.hpp"
+#include "libperf_pmu.h"
+
+/**
+ * @brief Declarations of libperf PMU event parsing API for C++
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	/**
+	 * @brief pmu_parse - translates an event description (e.g. "cpu/event=0xd1,umask=0x20/", "topdown-be-bound") into attributes, for use with the explicit Tracker constructor
+	 * @note Stub to libperf_pmu_parse()
+	 * @param const char *const spec - description of event
+	 * @return perf_event_attr - attributes of event
+	 * @throws std::system_error - thrown if the description couldn't be resolved
+	 * @note Category of std::system_error will be libperf::Error
+	 */
+	perf_event_attr pmu_parse(const char *const spec) noexcept(false) ;
+
+	/**
+	 * @brief pmu_tracepoint - resolves a tracepoint (e.g. "syscalls:sys_enter_futex") into attributes, for use with the explicit Tracker constructor
+	 * @note Stub to libperf_pmu_tracepoint()
+	 * @param const char *const name - tracepoint, as subsystem:event
+	 * @return perf_event_attr - attributes of event
+	 * @throws std::system_error - thrown if the tracepoint couldn't be resolved
+	 * @note Category of std::system_error will be libperf::Error
+	 */
+	perf_event_attr pmu_tracepoint(const char *const name) noexcept(false) ;
+
+	/**
+	 * @brief pmu_uprobe - creates the attributes of a uprobe on a function of a binary, for use with the explicit Tracker constructor
+	 * @note Stub to libperf_pmu_uprobe(). The attributes refer to path, so it must outlive construction of the Tracker
+	 * @param const char *const path - path of executable or shared library
+	 * @param const char *const symbol - function name, as it appears in the symbol table
+	 * @param const bool retprobe - whether to count returns from the function rather than entries
+	 * @return perf_event_attr - attributes of event
+	 * @throws std::system_error - thrown if the binary couldn't be read or function found
+	 * @note Category of std::system_error will either be std::generic_category, or libperf::Error, depending on the underlying C API
+	 */
+	perf_event_attr pmu_uprobe(const char *const path, const char *const symbol, const bool retprobe = false) noexcept(false) ;
+
+} // libperf
+
+#endif // LIBPERF_PMU_HPP
@@ -0,0 +1,375 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_process.h"
+
+/**
+ * @brief Definitions of libperf per-thread API and inner functionality
+ * @author Salih MSA
+ */
+
+struct libperf_process_tracker { /* lib struct */
+	pid_t pid; // process monitored
+	uint64_t events; // counters opened on each thread
+	uint64_t enabled; // counters currently toggled on, so threads attached later can follow suit
+	size_t count; // number of threads attached to
+	size_t capacity; // number of threads there's room for
+	pid_t *tids; // thread IDs
+	uint64_t *starts; // start time of each thread, telling a thread apart from a later one reusing its ID
+	libperf_tracker **trackers; // tracker of each thread
+	struct libperf_counter_value retired[LIBPERF_LIB_SW_WALL_TIME]; // final counts of threads detached from, indexed by enum libperf_event, so totals never go backwards
+};
+
+/**
+ * @brief libperf_process_grow - makes room for another thread
+ * @param libperf_process_tracker *const pt - tracker
+ * @return bool - false if out of memory
+ */
+static bool libperf_process_grow(libperf_process_tracker *const pt)
+{
+	if (pt->count < pt->capacity) {
+		return true;
+	}
+
+	const size_t capacity = pt->capacity == 0 ? 16 : pt->capacity * 2;
+
+	pid_t *const tids = realloc(pt->tids, capacity * sizeof(pid_t));
+	if (tids == NULL) {
+		return false;
+	}
+	pt->tids = tids;
+
+	uint64_t *const starts = realloc(pt->starts, capacity * sizeof(uint64_t));
+	if (starts == NULL) {
+		return false;
+	}
+	pt->starts = starts;
+
+	libperf_tracker **const trackers = realloc(pt->trackers, capacity * sizeof(libperf_tracker *));
+	if (trackers == NULL) {
+		return false;
+	}
+	pt->trackers = trackers;
+
+	pt->capacity = capacity;
+	return true;
+}
+
+/**
+ * @brief libperf_process_start - obtains when a thread started, from /proc/<pid>/task/<tid>/stat
+ * @param const pid_t pid - process thread belongs to
+ * @param const pid_t tid - thread ID
+ * @return uint64_t - start time, in clock ticks since boot, or 0 if the thread no longer exists
+ */
+static uint64_t libperf_process_start(const pid_t pid, const pid_t tid)
+{
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%d/task/%d/stat", pid, tid);
+
+	FILE *const file = fopen(path, "re");
+	if (file == NULL) {
+		return 0;
+	}
+
+	char stat[1024];
+	const size_t length = fread(stat, 1, sizeof(stat) - 1, file);
+	fclose(file);
+	stat[length] = '\0';
+
+	/* comm (field 2) may hold spaces & parentheses, so count fields from the last ')': state is field 3, starttime field 22 */
+	const char *field = strrchr(stat, ')');
+	if (field == NULL) {
+		return 0;
+	}
+	for (int i = 2; i < 22 && field != NULL; ++i) {
+		field = strchr(field + 1, ' ');
+	}
+
+	return field == NULL ? 0 : strtoull(field + 1, NULL, 10);
+}
+
+/**
+ * @brief libperf_process_detach - shuts down the tracker of an attached thread, removing it
+ * @note Its final counts are kept in the retired totals first (an exited thread's counters remain readable until closed)
+ * @param libperf_process_tracker *const pt - tracker
+ * @param const size_t index - index of thread
+ */
+static void libperf_process_detach(libperf_process_tracker *const pt, const size_t index)
+{
+	for (size_t i = 0; i < LIBPERF_LIB_SW_WALL_TIME; ++i) {
+		struct libperf_counter_value value;
+		if ((pt->events & LIBPERF_EVENT_MASK(i)) && libperf_read_counter_scaled(pt->trackers[index], (enum libperf_event)i, &value) == LIBPERF_EXIT_SUCCESS) {
+			pt->retired[i].raw += value.raw;
+			pt->retired[i].time_enabled += value.time_enabled;
+			pt->retired[i].time_running += value.time_running;
+			pt->retired[i].scaled += value.scaled;
+		}
+	}
+
+	libperf_fini(pt->trackers[index]);
+
+	/* shift the rest down, so the remaining threads keep their relative order */
+	const size_t following = pt->count - index - 1;
+	memmove(&pt->tids[index], &pt->tids[index + 1], following * sizeof(pid_t));
+	memmove(&pt->starts[index], &pt->starts[index + 1], following * sizeof(uint64_t));
+	memmove(&pt->trackers[index], &pt->trackers[index + 1], following * sizeof(libperf_tracker *));
+	--pt->count;
+}
+
+/**
+ * @brief libperf_process_prune - detaches from threads which have exited, or whose ID now belongs to another thread
+ * @param libperf_process_tracker *const pt - tracker
+ */
+static void libperf_process_prune(libperf_process_tracker *const pt)
+{
+	for (size_t i = pt->count; i-- > 0;) {
+		if (libperf_process_start(pt->pid, pt->tids[i]) != pt->starts[i]) {
+			libperf_process_detach(pt, i);
+		}
+	}
+}
+
+/**
+ * @brief libperf_process_scan - detaches from threads which have exited, then attaches to every thread listed in /proc/<pid>/task not yet attached to
+ * @param libperf_process_tracker *const pt - tracker
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+static enum libperf_exit libperf_process_scan(libperf_process_tracker *const pt)
+{
+	libperf_process_prune(pt); // first, so a reused thread ID isn't mistaken for the thread attached to
+
+	char path[64];
+	snprintf(path, sizeof(path), "/proc/%d/task", pt->pid);
+
+	DIR *const tasks = opendir(path);
+	if (tasks == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to list threads of process %d", __func__, pt->pid);
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	const struct dirent *entry;
+	while ((entry = readdir(tasks)) != NULL) {
+		char *end;
+		const long tid = strtol(entry->d_name, &end, 10);
+		if (*end != '\0' || tid <= 0) { // skip . and ..
+			continue;
+		}
+
+		const enum libperf_exit rt = libperf_process_attach(pt, (pid_t)tid);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			if (rt == LIBPERF_EXIT_SYSTEM_ERROR && errno == ESRCH) { // thread exited since being listed, nothing to count
+				continue;
+			}
+			closedir(tasks);
+			return rt;
+		}
+	}
+	closedir(tasks);
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+libperf_process_tracker *libperf_process_init(const pid_t pid, const uint64_t events)
+{
+	libperf_process_tracker *pt = calloc(1, sizeof(libperf_process_tracker));
+	if (pt == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", __func__);
+		return NULL;
+	}
+
+	pt->pid = pid == 0 ? getpid() : pid;
+	pt->events = events;
+
+	if (libperf_process_scan(pt) != LIBPERF_EXIT_SUCCESS) {
+		const int err = errno;
+		libperf_process_fini(pt);
+		errno = err;
+		return NULL;
+	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): tracking %lu threads of process %d", __func__, pt->count, pt->pid);
+	return pt;
+}
+
+enum libperf_exit libperf_process_attach(libperf_process_tracker *const pt, const pid_t tid)
+{
+	if (pt == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	const uint64_t start = libperf_process_start(pt->pid, tid);
+	for (size_t i = 0; i < pt->count; ++i) {
+		if (pt->tids[i] != tid) {
+			continue;
+		}
+		if (pt->starts[i] == start) { // already attached
+			return LIBPERF_EXIT_SUCCESS;
+		}
+		libperf_process_detach(pt, i); // ID reused by a new thread, so the tracker attached is of an exited one
+		break;
+	}
+
+	if (!libperf_process_grow(pt)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for thread %d", __func__, tid);
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	/* inheriting would have a thread's counters also count threads it spawns, which get attached to themselves - counting them twice */
+	libperf_tracker *const tracker = libperf_init_selective(tid, -1, pt->events, LIBPERF_INIT_NO_INHERIT);
+	if (tracker == NULL) {
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	for (size_t i = 0; i < LIBPERF_LIB_SW_WALL_TIME; ++i) {
+		if (pt->enabled & LIBPERF_EVENT_MASK(i)) {
+			const enum libperf_exit rt = libperf_toggle_counter(tracker, (enum libperf_event)i, LIBPERF_EVENT_TOGGLE_ON);
+			if (rt != LIBPERF_EXIT_SUCCESS) {
+				libperf_fini(tracker);
+				return rt;
+			}
+		}
+	}
+
+	pt->tids[pt->count] = tid;
+	pt->starts[pt->count] = start;
+	pt->trackers[pt->count] = tracker;
+	++pt->count;
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_process_rescan(libperf_process_tracker *const pt)
+{
+	if (pt == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	return libperf_process_scan(pt);
+}
+
+size_t libperf_process_count(const libperf_process_tracker *const pt)
+{
+	if (pt == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return pt->count;
+}
+
+pid_t libperf_process_tid(const libperf_process_tracker *const pt, const size_t index)
+{
+	if (pt == NULL || index >= pt->count) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle or thread index", __func__);
+		return -1;
+	}
+
+	return pt->tids[index];
+}
+
+enum libperf_exit libperf_process_toggle_counter(libperf_process_tracker *const pt, const enum libperf_event counter, const enum libperf_event_toggle toggle_type)
+{
+	if (pt == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (counter < 0 || counter >= LIBPERF_LIB_SW_WALL_TIME) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid perf event counter '%d' supplied", __func__, counter);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	if (toggle_type != LIBPERF_EVENT_TOGGLE_ON && toggle_type != LIBPERF_EVENT_TOGGLE_OFF && toggle_type != LIBPERF_EVENT_TOGGLE_RESET) { // others take arguments which make little sense to fan out
+		libperf_diag(LOG_ERR, "libperf (in %s): unsupported configuration supplied", __func__);
+		return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+
+	for (size_t i = 0; i < pt->count; ++i) {
+		const enum libperf_exit rt = libperf_toggle_counter(pt->trackers[i], counter, toggle_type);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+	}
+
+	if (toggle_type == LIBPERF_EVENT_TOGGLE_ON) {
+		pt->enabled |= LIBPERF_EVENT_MASK(counter);
+	} else if (toggle_type == LIBPERF_EVENT_TOGGLE_OFF) {
+		pt->enabled &= ~LIBPERF_EVENT_MASK(counter);
+	} else {
+		pt->retired[counter] = (struct libperf_counter_value){ 0, 0, 0, 0 }; // threads detached from count towards the total until it is reset
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_process_read_counter(libperf_process_tracker *const pt, const enum libperf_event counter, struct libperf_counter_value *const per_thread, struct libperf_counter_value *const total)
+{
+	if (pt == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (counter < 0 || counter >= LIBPERF_LIB_SW_WALL_TIME) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid perf event counter '%d' supplied", __func__, counter);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+
+	struct libperf_counter_value sum = pt->retired[counter]; // threads detached from still count
+
+	for (size_t i = 0; i < pt->count; ++i) {
+		struct libperf_counter_value value;
+		const enum libperf_exit rt = libperf_read_counter_scaled(pt->trackers[i], counter, &value);
+		if (rt != LIBPERF_EXIT_SUCCESS) {
+			return rt;
+		}
+
+		if (per_thread != NULL) {
+			per_thread[i] = value;
+		}
+
+		/* each thread is multiplexed independently, so scale per thread then sum */
+		sum.raw += value.raw;
+		sum.time_enabled += value.time_enabled;
+		sum.time_running += value.time_running;
+		sum.scaled += value.scaled;
+	}
+
+	if (total != NULL) {
+		*total = sum;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+void libperf_process_fini(libperf_process_tracker *const pt)
+{
+	if (pt == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return;
+	}
+
+	for (size_t i = 0; i < pt->count; ++i) {
+		libperf_fini(pt->trackers[i]);
+	}
+
+	free(pt->trackers);
+	free(pt->starts);
+	free(pt->tids);
+	free(pt);
+
+	libperf_diag(LOG_NOTICE, "libperf (in %s): process tracker shut down", __func__);
+}
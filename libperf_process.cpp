@@ -0,0 +1,127 @@
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_process.h"
+
+#include "libperf.hpp"
+#include "libperf_process.hpp"
+
+/**
+ * @brief Definitions of libperf per-thread API in C++
+ * @author Salih MSA
+ */
+
+libperf::ProcessTracker::ProcessTracker(const pid_t pid, const std::uint64_t events) noexcept(false)
+{
+	this->_tracker = libperf_process_init(pid, events) ;
+	if(this->_tracker == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::ProcessTracker::ProcessTracker(libperf::ProcessTracker&& tracker) noexcept
+{
+	this->_tracker = tracker._tracker ;
+	tracker._tracker = nullptr ;
+}
+
+libperf::ProcessTracker& libperf::ProcessTracker::operator=(libperf::ProcessTracker&& tracker) noexcept
+{
+	if(this != &tracker)
+	{
+		if(this->_tracker != nullptr)
+		{
+			libperf_process_fini(this->_tracker) ;
+		}
+		this->_tracker = tracker._tracker ;
+		tracker._tracker = nullptr ;
+	}
+
+	return *this ;
+}
+
+void libperf::ProcessTracker::attach(const pid_t tid) noexcept(false)
+{
+	const auto err = libperf_process_attach(this->_tracker, tid) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+void libperf::ProcessTracker::rescan() noexcept(false)
+{
+	const auto err = libperf_process_rescan(this->_tracker) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+std::size_t libperf::ProcessTracker::size() const noexcept
+{
+	return libperf_process_count(this->_tracker) ;
+}
+
+pid_t libperf::ProcessTracker::tid(const std::size_t index) const noexcept
+{
+	return libperf_process_tid(this->_tracker, index) ;
+}
+
+void libperf::ProcessTracker::toggle_counter(const libperf_event counter, const libperf_event_toggle toggle_type) noexcept(false)
+{
+	const auto err = libperf_process_toggle_counter(this->_tracker, counter, toggle_type) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+libperf_counter_value libperf::ProcessTracker::read_counter(const libperf_event counter, libperf_counter_value *const per_thread) const noexcept(false)
+{
+	libperf_counter_value total ;
+
+	const auto err = libperf_process_read_counter(this->_tracker, counter, per_thread, &total) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+
+	return total ;
+}
+
+libperf::ProcessTracker::~ProcessTracker() noexcept
+{
+	if(this->_tracker != nullptr)
+	{
+		libperf_process_fini(this->_tracker) ;
+	}
+}
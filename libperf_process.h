@@ -0,0 +1,100 @@
+#ifndef LIBPERF_PROCESS_H
+#define LIBPERF_PROCESS_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf per-thread API
+ * @note A process tracker attaches a (non-inheriting) libperf_tracker to every thread of a process, so counts can be broken down by thread as well as totalled
+ * @author Salih MSA
+ */
+
+struct libperf_process_tracker;
+typedef struct libperf_process_tracker libperf_process_tracker;
+
+/**
+ * @brief libperf_process_init - function attaches a tracker to every thread of a process, as listed in /proc/<pid>/task
+ * @param const pid_t pid - process ID to monitor
+ * @note Set 0 for the calling process
+ * @param const uint64_t events - mask of counters to open on each thread, built with LIBPERF_EVENT_MASK()
+ * @return libperf_process_tracker* - handle for use in future library calls
+ * @note return NULL if failure occurs, with errno set to the cause. Threads exiting whilst being attached to are skipped over
+ */
+libperf_process_tracker *libperf_process_init(const pid_t pid, const uint64_t events);
+
+/**
+ * @brief libperf_process_attach - function attaches to a single thread, if not already attached
+ * @note A thread reusing the ID of an exited thread attached to replaces it
+ * @note Intended as a hook for thread start routines (e.g. passing gettid()), so threads are picked up without waiting for a rescan
+ * @note Counters currently toggled on are toggled on for the new thread too
+ * @param libperf_process_tracker *const pt - handle obtained from libperf_process_init()
+ * @param const pid_t tid - thread ID
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_process_attach(libperf_process_tracker *const pt, const pid_t tid);
+
+/**
+ * @brief libperf_process_rescan - function attaches to threads created since the last scan, and detaches from those which have exited
+ * @note Call periodically to pick up new threads. Threads which have exited are dropped, so indices of per-thread arrays may shift, though their final counts remain part of totals
+ * @param libperf_process_tracker *const pt - handle obtained from libperf_process_init()
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_process_rescan(libperf_process_tracker *const pt);
+
+/**
+ * @brief libperf_process_count - function obtains how many threads are attached to
+ * @param const libperf_process_tracker *const pt - handle obtained from libperf_process_init()
+ * @return size_t - number of threads, ie size of per-thread arrays
+ */
+size_t libperf_process_count(const libperf_process_tracker *const pt);
+
+/**
+ * @brief libperf_process_tid - function obtains the ID of an attached thread
+ * @param const libperf_process_tracker *const pt - handle obtained from libperf_process_init()
+ * @param const size_t index - index into per-thread arrays
+ * @return pid_t - thread ID, or -1 if index is out of range
+ */
+pid_t libperf_process_tid(const libperf_process_tracker *const pt, const size_t index);
+
+/**
+ * @brief libperf_process_toggle_counter - function manipulates a counter on every thread
+ * @param libperf_process_tracker *const pt - handle obtained from libperf_process_init()
+ * @param const enum libperf_event counter - counter type
+ * @param const enum libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); stops at the first thread which fails
+ */
+enum libperf_exit libperf_process_toggle_counter(libperf_process_tracker *const pt, const enum libperf_event counter, const enum libperf_event_toggle toggle_type);
+
+/**
+ * @brief libperf_process_read_counter - function reads a counter on every thread
+ * @pre libperf_process_toggle_counter(..., counter, LIBPERF_EVENT_TOGGLE_ON) - enable counter
+ * @param libperf_process_tracker *const pt - handle obtained from libperf_process_init()
+ * @param const enum libperf_event counter - counter type
+ * @param struct libperf_counter_value *const per_thread - array of libperf_process_count() values to write each thread's value out to (may be NULL)
+ * @param struct libperf_counter_value *const total - value to write sum across threads out to, including the final counts of threads since detached from (until reset with LIBPERF_EVENT_TOGGLE_RESET) (may be NULL)
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_process_read_counter(libperf_process_tracker *const pt, const enum libperf_event counter, struct libperf_counter_value *const per_thread, struct libperf_counter_value *const total);
+
+/**
+ * @brief libperf_process_fini - function shuts down the tracker of every thread
+ * @param libperf_process_tracker *const pt - handle obtained from libperf_process_init()
+ */
+void libperf_process_fini(libperf_process_tracker *const pt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_PROCESS_H
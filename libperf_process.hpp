@@ -0,0 +1,116 @@
+#ifndef LIBPERF_PROCESS_HPP
+#define LIBPERF_PROCESS_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "libperf.hpp"
+#include "libperf_process.h"
+
+/**
+ * @brief Declarations of libperf per-thread API for C++
+ * @note Access to process trackers in C++ in via an RAII-complaint container
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	class ProcessTracker {
+		private:
+			libperf_process_tracker* _tracker ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief ProcessTracker (constructor) - attaches a tracker to every thread of a process
+			 * @note Stub to libperf_process_init()
+			 * @param const pid_t pid - process ID to monitor
+			 * @note Set 0 for the calling process
+			 * @param const std::uint64_t events - mask of counters to open on each thread, built with LIBPERF_EVENT_MASK()
+			 * @throws std::system_error - thrown if threads couldn't be attached to, with the errno which caused it
+			 */
+			explicit ProcessTracker(const pid_t pid, const std::uint64_t events) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as with libperf::Tracker
+			 */
+			ProcessTracker(const ProcessTracker& tracker) noexcept(false) = delete ;
+			ProcessTracker& operator=(const ProcessTracker& tracker) noexcept(false) = delete ;
+
+			/**
+			 * @brief ProcessTracker (move constructor) - acquire existing process tracker
+			 * @param ProcessTracker&& tracker - tracker to acquire
+			 */
+			explicit ProcessTracker(ProcessTracker&& tracker) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing process tracker, shutting down the one held
+			 * @param ProcessTracker&& tracker - tracker to acquire
+			 * @return ProcessTracker& - object which acquired
+			 */
+			ProcessTracker& operator=(ProcessTracker&& tracker) noexcept ;
+
+			/**
+			 * @brief attach - method attaches to a single thread, if not already attached
+			 * @note Stub to libperf_process_attach()
+			 * @param const pid_t tid - thread ID
+			 * @throws std::system_error - thrown if thread couldn't be attached to
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			void attach(const pid_t tid) noexcept(false) ;
+
+			/**
+			 * @brief rescan - method attaches to threads created since the last scan, and detaches from those which have exited
+			 * @note Stub to libperf_process_rescan()
+			 * @throws std::system_error - thrown if threads couldn't be listed or attached to
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			void rescan() noexcept(false) ;
+
+			/**
+			 * @brief size - method obtains how many threads are attached to
+			 * @note Stub to libperf_process_count()
+			 * @return std::size_t - number of threads, ie size of per-thread arrays
+			 */
+			std::size_t size() const noexcept ;
+
+			/**
+			 * @brief tid - method obtains the ID of an attached thread
+			 * @note Stub to libperf_process_tid()
+			 * @param const std::size_t index - index into per-thread arrays
+			 * @return pid_t - thread ID, or -1 if index is out of range
+			 */
+			pid_t tid(const std::size_t index) const noexcept ;
+
+			/**
+			 * @brief toggle_counter - method manipulates a counter on every thread
+			 * @note Stub to libperf_process_toggle_counter()
+			 * @param const libperf_event counter - counter type
+			 * @param const libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+			 * @throws std::system_error - thrown if we can't manipulate counter
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			void toggle_counter(const libperf_event counter, const libperf_event_toggle toggle_type) noexcept(false) ;
+
+			/**
+			 * @brief read_counter - method reads a counter on every thread
+			 * @note Stub to libperf_process_read_counter()
+			 * @param const libperf_event counter - counter type
+			 * @param libperf_counter_value *const per_thread - array of size() values to write each thread's value out to (may be nullptr)
+			 * @return libperf_counter_value - sum across threads
+			 * @throws std::system_error - thrown if we can't read value
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			libperf_counter_value read_counter(const libperf_event counter, libperf_counter_value *const per_thread = nullptr) const noexcept(false) ;
+
+			/**
+			 * @brief ~ProcessTracker - shuts down the tracker of every thread
+			 * @note Stub to libperf_process_fini()
+			 */
+			~ProcessTracker() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_PROCESS_HPP
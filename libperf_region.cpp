@@ -0,0 +1,189 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+
+#include "libperf.h"
+
+#include "libperf.hpp"
+#include "libperf_region.hpp"
+
+/**
+ * @brief Definitions of libperf region profiler in C++
+ * @author Salih MSA
+ */
+
+const std::size_t libperf::Region::max_regions ;
+const std::size_t libperf::Region::max_events ;
+
+namespace {
+
+	/* registry is constant initialised, so is usable by regions constructed during static initialisation */
+	std::atomic<libperf::Region*> registry[libperf::Region::max_regions] ; // a slot is claimed before its region is published, so may briefly read null
+	std::atomic<std::size_t> registered(0) ;
+
+	std::FILE* exit_stream = nullptr ;
+	libperf_event exit_events[libperf::Region::max_events] ;
+	std::size_t exit_count = 0 ;
+
+	void report_exit() noexcept
+	{
+		libperf::Region::report(exit_stream, exit_events, exit_count) ;
+	}
+
+} // anonymous
+
+libperf::Region::Region(const char *const name) noexcept : _name(name), _count(0), _failed(0)
+{
+	for(std::size_t i = 0 ; i < max_events ; ++i)
+	{
+		this->_sum[i].store(0, std::memory_order_relaxed) ;
+		this->_min[i].store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed) ;
+		this->_max[i].store(0, std::memory_order_relaxed) ;
+	}
+
+	const std::size_t slot = registered.fetch_add(1, std::memory_order_relaxed) ;
+	if(slot < max_regions)
+	{
+		registry[slot].store(this, std::memory_order_release) ; // release pairs with report()'s acquire, so the region is seen constructed
+	}
+}
+
+const char* libperf::Region::name() const noexcept
+{
+	return this->_name ;
+}
+
+std::uint64_t libperf::Region::count() const noexcept
+{
+	return this->_count.load(std::memory_order_relaxed) ;
+}
+
+std::uint64_t libperf::Region::failed() const noexcept
+{
+	return this->_failed.load(std::memory_order_relaxed) ;
+}
+
+std::uint64_t libperf::Region::sum(const std::size_t event) const noexcept
+{
+	return event < max_events ? this->_sum[event].load(std::memory_order_relaxed) : 0 ;
+}
+
+std::uint64_t libperf::Region::min(const std::size_t event) const noexcept
+{
+	if(event >= max_events || this->count() == 0)
+	{
+		return 0 ;
+	}
+
+	return this->_min[event].load(std::memory_order_relaxed) ;
+}
+
+std::uint64_t libperf::Region::max(const std::size_t event) const noexcept
+{
+	return event < max_events ? this->_max[event].load(std::memory_order_relaxed) : 0 ;
+}
+
+void libperf::Region::record(const std::uint64_t *const begin, const std::uint64_t *const end, const std::size_t events) noexcept
+{
+	const std::size_t count = events < max_events ? events : max_events ;
+
+	for(std::size_t i = 0 ; i < count ; ++i)
+	{
+		const std::uint64_t delta = end[i] - begin[i] ;
+
+		this->_sum[i].fetch_add(delta, std::memory_order_relaxed) ;
+
+		/* statistics are independent of one another, so relaxed compare-and-swap loops suffice */
+		std::uint64_t current = this->_min[i].load(std::memory_order_relaxed) ;
+		while(delta < current && !this->_min[i].compare_exchange_weak(current, delta, std::memory_order_relaxed)) ;
+
+		current = this->_max[i].load(std::memory_order_relaxed) ;
+		while(delta > current && !this->_max[i].compare_exchange_weak(current, delta, std::memory_order_relaxed)) ;
+	}
+
+	this->_count.fetch_add(1, std::memory_order_relaxed) ;
+}
+
+void libperf::Region::record_failure() noexcept
+{
+	this->_failed.fetch_add(1, std::memory_order_relaxed) ;
+}
+
+void libperf::Region::report(std::FILE *const stream, const libperf_event *const events, const std::size_t count) noexcept
+{
+	if(stream == nullptr)
+	{
+		return ;
+	}
+
+	const std::size_t regions = registered.load(std::memory_order_relaxed) ;
+	const std::size_t reported = regions < max_regions ? regions : max_regions ;
+	const std::size_t columns = count < max_events ? count : max_events ;
+
+	for(std::size_t r = 0 ; r < reported ; ++r)
+	{
+		const Region *const published = registry[r].load(std::memory_order_acquire) ;
+		if(published == nullptr) // slot claimed by a region still being constructed
+		{
+			continue ;
+		}
+		const Region& region = *published ;
+		const std::uint64_t passes = region.count() ;
+
+		std::fprintf(stream, "%s: %lu passes (%lu unaccounted)\n", region.name(), passes, region.failed()) ;
+		for(std::size_t i = 0 ; i < columns ; ++i)
+		{
+			const char *const event = libperf_event_name(events[i]) ;
+			const double mean = passes == 0 ? 0.0 : static_cast<double>(region.sum(i)) / static_cast<double>(passes) ;
+			std::fprintf(stream, "\t%s: sum %lu mean %.2f min %lu max %lu\n", event == nullptr ? "UNKNOWN" : event, region.sum(i), mean, region.min(i), region.max(i)) ;
+		}
+	}
+
+	if(regions > max_regions)
+	{
+		std::fprintf(stream, "(%lu further regions not reported)\n", regions - max_regions) ;
+	}
+
+	std::fflush(stream) ;
+}
+
+void libperf::Region::report_at_exit(std::FILE *const stream, std::initializer_list<libperf_event> events) noexcept
+{
+	exit_stream = stream ;
+	exit_count = 0 ;
+	for(const libperf_event event : events)
+	{
+		if(exit_count == max_events)
+		{
+			break ;
+		}
+		exit_events[exit_count++] = event ;
+	}
+
+	std::atexit(report_exit) ;
+}
+
+libperf::ScopedRegion::ScopedRegion(libperf::Region& region, const libperf::Tracker& tracker) noexcept : _region(region), _tracker(tracker.handle()), _events(tracker.group_size())
+{
+	if(this->_events == 0 || this->_events > Region::max_events || libperf_read_group(this->_tracker, this->_begin) != LIBPERF_EXIT_SUCCESS)
+	{
+		this->_tracker = nullptr ;
+	}
+}
+
+libperf::ScopedRegion::~ScopedRegion() noexcept
+{
+	std::uint64_t end[Region::max_events] ;
+
+	if(this->_tracker == nullptr || libperf_read_group(this->_tracker, end) != LIBPERF_EXIT_SUCCESS)
+	{
+		this->_region.record_failure() ;
+		return ;
+	}
+
+	this->_region.record(this->_begin, end, this->_events) ;
+}
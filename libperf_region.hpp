@@ -0,0 +1,162 @@
+#ifndef LIBPERF_REGION_HPP
+#define LIBPERF_REGION_HPP
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdint>
+#include <initializer_list>
+
+#include "libperf.h"
+#include "libperf.hpp"
+
+/**
+ * @brief Declarations of libperf region profiler for C++
+ * @note A region is a named section of code, such as a function. Every time it's entered & exited (see ScopedRegion), the counters of a group are read and the deltas accumulated into the region's statistics - without throwing, allocating or locking
+ * @author Salih MSA
+ */
+
+#define LIBPERF_REGION_CONCAT_(a, b) a##b
+#define LIBPERF_REGION_CONCAT(a, b) LIBPERF_REGION_CONCAT_(a, b)
+
+/**
+ * @brief LIBPERF_SCOPED_REGION - profiles the rest of the enclosing scope as a static region
+ * @param name - name of region (a string literal)
+ * @param tracker - libperf::Tracker, constructed with a group, monitoring the calling thread
+ */
+#define LIBPERF_SCOPED_REGION(name, tracker) \
+	static libperf::Region LIBPERF_REGION_CONCAT(libperf_region_, __LINE__)(name) ; \
+	const libperf::ScopedRegion LIBPERF_REGION_CONCAT(libperf_scoped_region_, __LINE__)(LIBPERF_REGION_CONCAT(libperf_region_, __LINE__), tracker)
+
+namespace libperf {
+
+	class Region {
+		public:
+			static const std::size_t max_regions = 256 ; // regions which can be registered for reports
+			static const std::size_t max_events = 8 ; // group members which statistics are kept for
+
+		private:
+			const char* _name ;
+			std::atomic<std::uint64_t> _count ; // times region was exited
+			std::atomic<std::uint64_t> _failed ; // times counters couldn't be read, so weren't accounted for
+			std::atomic<std::uint64_t> _sum[max_events] ;
+			std::atomic<std::uint64_t> _min[max_events] ;
+			std::atomic<std::uint64_t> _max[max_events] ;
+
+		public:
+			/**
+			 * @brief Region (constructor) - creates and registers a region
+			 * @note Meant to be a static (function-local or global), as it's registered for the lifetime of the program. Regions beyond max_regions still accumulate, but aren't reported
+			 * @param const char *const name - name of region, which must outlive it (e.g. a string literal)
+			 */
+			explicit Region(const char *const name) noexcept ;
+
+			/**
+			 * @note Copy & move deleted, as the registry holds onto the region's address
+			 */
+			Region(const Region& region) = delete ;
+			Region& operator=(const Region& region) = delete ;
+
+			/**
+			 * @brief name - method obtains name of region
+			 * @return const char* - name
+			 */
+			const char* name() const noexcept ;
+
+			/**
+			 * @brief count - method obtains how many times the region was accounted for
+			 * @return std::uint64_t - number of times
+			 */
+			std::uint64_t count() const noexcept ;
+
+			/**
+			 * @brief failed - method obtains how many times the region couldn't be accounted for, as counters couldn't be read
+			 * @return std::uint64_t - number of times
+			 */
+			std::uint64_t failed() const noexcept ;
+
+			/**
+			 * @brief sum - method obtains the total delta of a group member across every time the region was accounted for
+			 * @param const std::size_t event - index of group member
+			 * @return std::uint64_t - total, or 0 if index is out of range
+			 */
+			std::uint64_t sum(const std::size_t event) const noexcept ;
+
+			/**
+			 * @brief min - method obtains the smallest delta of a group member
+			 * @param const std::size_t event - index of group member
+			 * @return std::uint64_t - smallest delta, or 0 if never accounted for or index is out of range
+			 */
+			std::uint64_t min(const std::size_t event) const noexcept ;
+
+			/**
+			 * @brief max - method obtains the largest delta of a group member
+			 * @param const std::size_t event - index of group member
+			 * @return std::uint64_t - largest delta, or 0 if index is out of range
+			 */
+			std::uint64_t max(const std::size_t event) const noexcept ;
+
+			/**
+			 * @brief record - method accumulates one pass through the region
+			 * @note Safe to call from many threads at once
+			 * @param const std::uint64_t *const begin - values of group members on entry
+			 * @param const std::uint64_t *const end - values of group members on exit
+			 * @param const std::size_t events - number of group members (at most max_events)
+			 */
+			void record(const std::uint64_t *const begin, const std::uint64_t *const end, const std::size_t events) noexcept ;
+
+			/**
+			 * @brief record_failure - method notes a pass through the region which couldn't be accounted for
+			 */
+			void record_failure() noexcept ;
+
+			/**
+			 * @brief report - writes statistics of every registered region
+			 * @param std::FILE *const stream - output stream
+			 * @param const libperf_event *const events - members of group regions were measured with, to name statistics after
+			 * @param const std::size_t count - number of members
+			 */
+			static void report(std::FILE *const stream, const libperf_event *const events, const std::size_t count) noexcept ;
+
+			/**
+			 * @brief report_at_exit - arranges for report() to be called when the program exits
+			 * @param std::FILE *const stream - output stream, which must remain open until then
+			 * @param std::initializer_list<libperf_event> events - members of group regions were measured with (at most max_events)
+			 */
+			static void report_at_exit(std::FILE *const stream, std::initializer_list<libperf_event> events) noexcept ;
+
+	} ;
+
+	class ScopedRegion {
+		private:
+			Region& _region ;
+			libperf_tracker* _tracker ; // group being read, or nullptr if the entry read failed
+			std::size_t _events ;
+			std::uint64_t _begin[Region::max_events] ;
+
+		public:
+			/**
+			 * @brief ScopedRegion (constructor) - enters a region, reading the group's counters
+			 * @note Set the tracker's read mode to LIBPERF_READ_MODE_RDPMC for reads without syscalls
+			 * @param Region& region - region being entered
+			 * @param const Tracker& tracker - tracker constructed with a group (of at most Region::max_events members), monitoring the calling thread; a thread_local one suits multithreaded code
+			 */
+			explicit ScopedRegion(Region& region, const Tracker& tracker) noexcept ;
+
+			/**
+			 * @note Copy & move deleted, as a region is exited exactly once
+			 */
+			ScopedRegion(const ScopedRegion& scoped) = delete ;
+			ScopedRegion& operator=(const ScopedRegion& scoped) = delete ;
+
+			/**
+			 * @brief ~ScopedRegion - exits the region, reading the group's counters again and accumulating the deltas
+			 */
+			~ScopedRegion() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_REGION_HPP
@@ -0,0 +1,281 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include <linux/perf_event.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_sampler.h"
+
+/**
+ * @brief Definitions of libperf sampling API and inner functionality
+ * @author Salih MSA
+ */
+
+#define LIBPERF_SAMPLER_MAX_RECORD 65536 // records' sizes are 16 bit, so this is as large as one can get
+
+struct libperf_sampler { /* lib struct */
+	int fd; // sampled event
+	uint64_t sample_type; // layout of PERF_RECORD_SAMPLE records
+	struct perf_event_mmap_page *meta; // first page of mapping, holding ring buffer head & tail
+	size_t mapped; // size of whole mapping
+	unsigned char *data; // ring buffer itself
+	uint64_t size; // size of ring buffer, a power of two
+	uint64_t head; // last data_head seen, ie up to where records can be read without consulting kernel again
+	uint64_t tail; // end of last record handed out
+	uint64_t lost; // tally of records kernel dropped
+	uint64_t scratch[LIBPERF_SAMPLER_MAX_RECORD / sizeof(uint64_t)]; // where records wrapping around the ring buffer are stitched back together
+};
+
+static inline int sys_perf_event_open(struct perf_event_attr *const hw_event, const pid_t id, const int cpu, const int group_fd, const unsigned long flags)
+{
+	return (int)syscall(__NR_perf_event_open, hw_event, id, cpu, group_fd, flags);
+}
+
+libperf_sampler *libperf_sampler_init(const pid_t id, const int cpu, const enum libperf_event event, const uint64_t period, const bool frequency, const uint64_t sample_type, const size_t pages)
+{
+	if ((sample_type & ~(uint64_t)LIBPERF_SAMPLE_SUPPORTED) != 0 || period == 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unsupported sample configuration supplied", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	struct perf_event_attr attr;
+	if (libperf_event_attr(event, &attr) != LIBPERF_EXIT_SUCCESS) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	attr.sample_type = sample_type;
+	if (frequency) {
+		attr.freq = 1;
+		attr.sample_freq = period;
+	} else {
+		attr.sample_period = period;
+	}
+	attr.disabled = 1; // specifics: disable sampler by default
+	if (id != -1) { // as with counters, stick to userspace unless doing system wide analysis
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+	}
+
+	return libperf_sampler_init_attr(id, cpu, &attr, pages);
+}
+
+libperf_sampler *libperf_sampler_init_attr(const pid_t id, const int cpu, const struct perf_event_attr *const attr, const size_t pages)
+{
+	if (attr == NULL || pages == 0 || (pages & (pages - 1)) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): ring buffer must be a power of two pages", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	libperf_sampler *sampler = malloc(sizeof(libperf_sampler));
+	if (sampler == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", __func__);
+		return NULL;
+	}
+
+	struct perf_event_attr local = *attr;
+	local.size = sizeof(struct perf_event_attr); // specifics: we include this due to kernel backcompatibility issues
+
+	sampler->fd = sys_perf_event_open(&local, id, cpu, -1, 0);
+	if (sampler->fd < 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to open sampled event; refer to documentation & manual pages", __func__);
+		free(sampler);
+		return NULL;
+	}
+
+	const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	sampler->mapped = (1 + pages) * page_size; // ring buffer is preceded by a metadata page
+	void *const mapping = mmap(NULL, sampler->mapped, PROT_READ | PROT_WRITE, MAP_SHARED, sampler->fd, 0); // writable, as that's how we tell kernel what we've consumed
+	if (mapping == MAP_FAILED) {
+		const int err = errno;
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to map ring buffer", __func__);
+		close(sampler->fd);
+		free(sampler);
+		errno = err;
+		return NULL;
+	}
+
+	sampler->meta = mapping;
+	if (sampler->meta->data_offset != 0) { // newer kernels say where ring buffer lives
+		sampler->data = (unsigned char *)mapping + sampler->meta->data_offset;
+		sampler->size = sampler->meta->data_size;
+	} else {
+		sampler->data = (unsigned char *)mapping + page_size;
+		sampler->size = pages * page_size;
+	}
+	sampler->sample_type = local.sample_type;
+	sampler->head = 0;
+	sampler->tail = 0;
+	sampler->lost = 0;
+
+	libperf_diag(LOG_INFO, "libperf (in %s): sampler initialised", __func__);
+	return sampler;
+}
+
+enum libperf_exit libperf_sampler_toggle(libperf_sampler *const sampler, const enum libperf_event_toggle toggle_type)
+{
+	if (sampler == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	unsigned long request;
+	switch (toggle_type) {
+		case LIBPERF_EVENT_TOGGLE_ON:;
+			request = PERF_EVENT_IOC_ENABLE;
+			break;
+		case LIBPERF_EVENT_TOGGLE_OFF:;
+			request = PERF_EVENT_IOC_DISABLE;
+			break;
+		case LIBPERF_EVENT_TOGGLE_RESET:;
+			request = PERF_EVENT_IOC_RESET;
+			break;
+		default:;
+			libperf_diag(LOG_ERR, "libperf (in %s): unsupported configuration supplied", __func__);
+			return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+
+	if (ioctl(sampler->fd, request) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to configure sampler", __func__);
+		return LIBPERF_EXIT_SYSTEM_ERROR;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+const struct perf_event_header *libperf_sampler_next(libperf_sampler *const sampler)
+{
+	if (sampler == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return NULL;
+	}
+
+	/* hand back the previous record; release pairs with kernel's read of data_tail before overwriting anything */
+	__atomic_store_n(&sampler->meta->data_tail, sampler->tail, __ATOMIC_RELEASE);
+
+	if (sampler->tail == sampler->head) { // caught up with what we last knew, so see whether kernel has written more
+		sampler->head = __atomic_load_n(&sampler->meta->data_head, __ATOMIC_ACQUIRE); // acquire pairs with kernel's write of records before data_head
+		if (sampler->tail == sampler->head) {
+			return NULL;
+		}
+	}
+
+	/* records are 8 byte aligned and the ring buffer a power of two in size, so a header itself never wraps around */
+	const uint64_t offset = sampler->tail & (sampler->size - 1);
+	const struct perf_event_header *record = (const struct perf_event_header *)(sampler->data + offset);
+	const uint64_t record_size = record->size;
+
+	if (offset + record_size > sampler->size) { // record wraps around, so stitch it back together
+		const size_t first = (size_t)(sampler->size - offset);
+		memcpy(sampler->scratch, sampler->data + offset, first);
+		memcpy((unsigned char *)sampler->scratch + first, sampler->data, (size_t)record_size - first);
+		record = (const struct perf_event_header *)sampler->scratch;
+	}
+
+	sampler->tail += record_size;
+
+	if (record->type == PERF_RECORD_LOST) { // layout: { struct perf_event_header header; u64 id; u64 lost; ... }
+		sampler->lost += ((const uint64_t *)(record + 1))[1];
+	}
+
+	return record;
+}
+
+enum libperf_exit libperf_sampler_parse(const libperf_sampler *const sampler, const struct perf_event_header *const record, struct libperf_sample *const sample)
+{
+	if (sampler == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (record == NULL || record->type != PERF_RECORD_SAMPLE || (sampler->sample_type & ~(uint64_t)LIBPERF_SAMPLE_SUPPORTED) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): record is not a sample libperf can decode", __func__);
+		return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+
+	memset(sample, 0, sizeof(struct libperf_sample));
+
+	/* fields follow the header in the order listed in linux/perf_event.h, each present only if requested */
+	const uint64_t *field = (const uint64_t *)(record + 1);
+	const uint64_t type = sampler->sample_type;
+
+	if (type & PERF_SAMPLE_IDENTIFIER) {
+		sample->id = *field++;
+	}
+	if (type & PERF_SAMPLE_IP) {
+		sample->ip = *field++;
+	}
+	if (type & PERF_SAMPLE_TID) { // { u32 pid, tid; }
+		const uint32_t *const ids = (const uint32_t *)field++;
+		sample->pid = ids[0];
+		sample->tid = ids[1];
+	}
+	if (type & PERF_SAMPLE_TIME) {
+		sample->time = *field++;
+	}
+	if (type & PERF_SAMPLE_ADDR) {
+		sample->addr = *field++;
+	}
+	if (type & PERF_SAMPLE_ID) {
+		sample->id = *field++;
+	}
+	if (type & PERF_SAMPLE_STREAM_ID) {
+		sample->stream_id = *field++;
+	}
+	if (type & PERF_SAMPLE_CPU) { // { u32 cpu, res; }
+		sample->cpu = ((const uint32_t *)field++)[0];
+	}
+	if (type & PERF_SAMPLE_PERIOD) {
+		sample->period = *field++;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+uint64_t libperf_sampler_lost(const libperf_sampler *const sampler)
+{
+	if (sampler == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return sampler->lost;
+}
+
+int libperf_sampler_fd(const libperf_sampler *const sampler)
+{
+	if (sampler == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return -1;
+	}
+
+	return sampler->fd;
+}
+
+void libperf_sampler_fini(libperf_sampler *const sampler)
+{
+	if (sampler == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return;
+	}
+
+	munmap(sampler->meta, sampler->mapped);
+	close(sampler->fd);
+	free(sampler);
+
+	libperf_diag(LOG_NOTICE, "libperf (in %s): sampler shut down", __func__);
+}
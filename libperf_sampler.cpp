@@ -0,0 +1,105 @@
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_sampler.h"
+
+#include "libperf.hpp"
+#include "libperf_sampler.hpp"
+
+/**
+ * @brief Definitions of libperf sampling API in C++
+ * @author Salih MSA
+ */
+
+libperf::Sampler::Sampler(const pid_t id, const int cpu, const libperf_event event, const std::uint64_t period, const bool frequency, const std::uint64_t sample_type, const std::size_t pages) noexcept(false)
+{
+	this->_sampler = libperf_sampler_init(id, cpu, event, period, frequency, sample_type, pages) ;
+	if(this->_sampler == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Sampler::Sampler(const pid_t id, const int cpu, const perf_event_attr& attr, const std::size_t pages) noexcept(false)
+{
+	this->_sampler = libperf_sampler_init_attr(id, cpu, &attr, pages) ;
+	if(this->_sampler == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Sampler::Sampler(libperf::Sampler&& sampler) noexcept
+{
+	this->_sampler = sampler._sampler ;
+	sampler._sampler = nullptr ;
+}
+
+libperf::Sampler& libperf::Sampler::operator=(libperf::Sampler&& sampler) noexcept
+{
+	if(this != &sampler)
+	{
+		if(this->_sampler != nullptr)
+		{
+			libperf_sampler_fini(this->_sampler) ;
+		}
+		this->_sampler = sampler._sampler ;
+		sampler._sampler = nullptr ;
+	}
+
+	return *this ;
+}
+
+void libperf::Sampler::toggle(const libperf_event_toggle toggle_type) noexcept(false)
+{
+	const auto err = libperf_sampler_toggle(this->_sampler, toggle_type) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+const perf_event_header* libperf::Sampler::next() noexcept
+{
+	return libperf_sampler_next(this->_sampler) ;
+}
+
+libperf_sample libperf::Sampler::parse(const perf_event_header *const record) const noexcept(false)
+{
+	libperf_sample sample ;
+
+	const auto err = libperf_sampler_parse(this->_sampler, record, &sample) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		throw std::system_error(err, libperf::Error()) ;
+	}
+
+	return sample ;
+}
+
+std::uint64_t libperf::Sampler::lost() const noexcept
+{
+	return libperf_sampler_lost(this->_sampler) ;
+}
+
+int libperf::Sampler::fd() const noexcept
+{
+	return libperf_sampler_fd(this->_sampler) ;
+}
+
+libperf::Sampler::~Sampler() noexcept
+{
+	if(this->_sampler != nullptr)
+	{
+		libperf_sampler_fini(this->_sampler) ;
+	}
+}
@@ -0,0 +1,124 @@
+#ifndef LIBPERF_SAMPLER_H
+#define LIBPERF_SAMPLER_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <linux/perf_event.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf sampling API
+ * @note Rather than counting how many events occured, a sampler records where they occured: every period events (or at a given frequency) the kernel writes a PERF_RECORD_SAMPLE into a ring buffer, which this API reads back without copying
+ * @note See https://man7.org/linux/man-pages/man2/perf_event_open.2.html for constructs this library wraps
+ * @author Salih MSA
+ */
+
+struct libperf_sampler;
+typedef struct libperf_sampler libperf_sampler;
+
+#define LIBPERF_SAMPLE_SUPPORTED (PERF_SAMPLE_IDENTIFIER | PERF_SAMPLE_IP | PERF_SAMPLE_TID | PERF_SAMPLE_TIME | PERF_SAMPLE_ADDR | PERF_SAMPLE_ID | PERF_SAMPLE_STREAM_ID | PERF_SAMPLE_CPU | PERF_SAMPLE_PERIOD) // sample_type fields libperf_sampler_parse() can decode
+
+struct libperf_sample { /* decoded PERF_RECORD_SAMPLE; fields not requested in sample_type are zeroed */
+	uint64_t id; // PERF_SAMPLE_ID / PERF_SAMPLE_IDENTIFIER
+	uint64_t ip; // PERF_SAMPLE_IP - instruction pointer
+	uint32_t pid; // PERF_SAMPLE_TID - process ID
+	uint32_t tid; // PERF_SAMPLE_TID - thread ID
+	uint64_t time; // PERF_SAMPLE_TIME - timestamp, in nanoseconds
+	uint64_t addr; // PERF_SAMPLE_ADDR - address accessed, if applicable to the event
+	uint64_t stream_id; // PERF_SAMPLE_STREAM_ID
+	uint32_t cpu; // PERF_SAMPLE_CPU - CPU sample was taken on
+	uint64_t period; // PERF_SAMPLE_PERIOD - events this sample stands for
+};
+
+/**
+ * @brief libperf_sampler_init - function creates a sampler for one of libperf's counters
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @note Set -1 for system wide readings
+ * @param const int cpu - pass in specific cpuid to track
+ * @note Set -1 for readings on all CPUs. Unlike counters, samples of children aren't inherited
+ * @param const enum libperf_event event - counter to sample
+ * @param const uint64_t period - take a sample every `period` events, or `period` times a second if frequency is set
+ * @param const bool frequency - whether period is a frequency (in Hz), the kernel adjusting the period to match
+ * @param const uint64_t sample_type - bitwise OR of PERF_SAMPLE_* fields to record; must be within LIBPERF_SAMPLE_SUPPORTED
+ * @param const size_t pages - size of ring buffer in pages; must be a power of two
+ * @return libperf_sampler* - handle for use in future library calls, initially disabled
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_sampler *libperf_sampler_init(const pid_t id, const int cpu, const enum libperf_event event, const uint64_t period, const bool frequency, const uint64_t sample_type, const size_t pages);
+
+/**
+ * @brief libperf_sampler_init_attr - function creates a sampler for an event described by the caller
+ * @note Records other than samples (e.g. context switches, see perf_event_attr) can be requested here too, and are returned by libperf_sampler_next()
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @param const int cpu - pass in specific cpuid to track
+ * @param const struct perf_event_attr *const attr - attributes of event; its size is filled in
+ * @param const size_t pages - size of ring buffer in pages; must be a power of two
+ * @return libperf_sampler* - handle for use in future library calls
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_sampler *libperf_sampler_init_attr(const pid_t id, const int cpu, const struct perf_event_attr *const attr, const size_t pages);
+
+/**
+ * @brief libperf_sampler_toggle - function enables, disables or resets a sampler
+ * @param libperf_sampler *const sampler - handle obtained from libperf_sampler_init()
+ * @param const enum libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_sampler_toggle(libperf_sampler *const sampler, const enum libperf_event_toggle toggle_type);
+
+/**
+ * @brief libperf_sampler_next - function obtains the next record from the ring buffer
+ * @note Records are returned in place (zero-copy); only a record wrapping around the end of the ring buffer is copied, into a buffer owned by the sampler
+ * @note Calling this releases the previously returned record back to the kernel, so that record must no longer be used
+ * @note PERF_RECORD_LOST records are also tallied, see libperf_sampler_lost()
+ * @param libperf_sampler *const sampler - handle obtained from libperf_sampler_init()
+ * @return const struct perf_event_header* - next record (see PERF_RECORD_* in linux/perf_event.h), or NULL if the ring buffer is drained
+ */
+const struct perf_event_header *libperf_sampler_next(libperf_sampler *const sampler);
+
+/**
+ * @brief libperf_sampler_parse - function decodes a PERF_RECORD_SAMPLE record
+ * @param const libperf_sampler *const sampler - handle the record was obtained from
+ * @param const struct perf_event_header *const record - record obtained from libperf_sampler_next()
+ * @param struct libperf_sample *const sample - sample to write out to
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED if record isn't a sample, or holds fields outside LIBPERF_SAMPLE_SUPPORTED
+ */
+enum libperf_exit libperf_sampler_parse(const libperf_sampler *const sampler, const struct perf_event_header *const record, struct libperf_sample *const sample);
+
+/**
+ * @brief libperf_sampler_lost - function obtains how many records the kernel dropped as the ring buffer was full
+ * @note Only includes PERF_RECORD_LOST records libperf_sampler_next() has come across so far
+ * @param const libperf_sampler *const sampler - handle obtained from libperf_sampler_init()
+ * @return uint64_t - number of records lost
+ */
+uint64_t libperf_sampler_lost(const libperf_sampler *const sampler);
+
+/**
+ * @brief libperf_sampler_fd - function obtains the file descriptor of the sampler's event
+ * @note Can be used with poll() to wait for the ring buffer to fill (see wakeup_events in perf_event_attr)
+ * @param const libperf_sampler *const sampler - handle obtained from libperf_sampler_init()
+ * @return int - file descriptor, or -1 if the handle is invalid
+ */
+int libperf_sampler_fd(const libperf_sampler *const sampler);
+
+/**
+ * @brief libperf_sampler_fini - function shuts down a sampler, unmapping its ring buffer
+ * @param libperf_sampler *const sampler - handle obtained from libperf_sampler_init()
+ */
+void libperf_sampler_fini(libperf_sampler *const sampler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_SAMPLER_H
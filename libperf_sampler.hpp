@@ -0,0 +1,118 @@
+#ifndef LIBPERF_SAMPLER_HPP
+#define LIBPERF_SAMPLER_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "libperf.hpp"
+#include "libperf_sampler.h"
+
+/**
+ * @brief Declarations of libperf sampling API for C++
+ * @note Access to samplers in C++ in via an RAII-complaint container
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	class Sampler {
+		private:
+			libperf_sampler* _sampler ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief Sampler (constructor) - creates a sampler for one of libperf's counters
+			 * @note Stub to libperf_sampler_init()
+			 * @param const pid_t id - process ID *or* thread ID to monitor
+			 * @param const int cpu - pass in specific cpuid to track
+			 * @param const libperf_event event - counter to sample
+			 * @param const std::uint64_t period - take a sample every `period` events, or `period` times a second if frequency is set
+			 * @param const bool frequency - whether period is a frequency (in Hz)
+			 * @param const std::uint64_t sample_type - bitwise OR of PERF_SAMPLE_* fields to record; must be within LIBPERF_SAMPLE_SUPPORTED
+			 * @param const std::size_t pages - size of ring buffer in pages; must be a power of two
+			 * @throws std::system_error - thrown if the sampler couldn't be created, with the errno which caused it
+			 */
+			explicit Sampler(const pid_t id, const int cpu, const libperf_event event, const std::uint64_t period, const bool frequency, const std::uint64_t sample_type, const std::size_t pages) noexcept(false) ;
+
+			/**
+			 * @brief Sampler (constructor) - creates a sampler for an event described by the caller
+			 * @note Stub to libperf_sampler_init_attr()
+			 * @param const pid_t id - process ID *or* thread ID to monitor
+			 * @param const int cpu - pass in specific cpuid to track
+			 * @param const perf_event_attr& attr - attributes of event
+			 * @param const std::size_t pages - size of ring buffer in pages; must be a power of two
+			 * @throws std::system_error - thrown if the sampler couldn't be created, with the errno which caused it
+			 */
+			explicit Sampler(const pid_t id, const int cpu, const perf_event_attr& attr, const std::size_t pages) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as the ring buffer has one reader
+			 */
+			Sampler(const Sampler& sampler) noexcept(false) = delete ;
+			Sampler& operator=(const Sampler& sampler) noexcept(false) = delete ;
+
+			/**
+			 * @brief Sampler (move constructor) - acquire existing sampler
+			 * @param Sampler&& sampler - sampler to acquire
+			 */
+			explicit Sampler(Sampler&& sampler) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing sampler, shutting down the one held
+			 * @param Sampler&& sampler - sampler to acquire
+			 * @return Sampler& - object which acquired
+			 */
+			Sampler& operator=(Sampler&& sampler) noexcept ;
+
+			/**
+			 * @brief toggle - method enables, disables or resets the sampler
+			 * @note Stub to libperf_sampler_toggle()
+			 * @param const libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+			 * @throws std::system_error - thrown if we can't manipulate sampler
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error
+			 */
+			void toggle(const libperf_event_toggle toggle_type) noexcept(false) ;
+
+			/**
+			 * @brief next - method obtains the next record from the ring buffer, releasing the previous one
+			 * @note Stub to libperf_sampler_next()
+			 * @return const perf_event_header* - next record, or nullptr if the ring buffer is drained
+			 */
+			const perf_event_header* next() noexcept ;
+
+			/**
+			 * @brief parse - method decodes a PERF_RECORD_SAMPLE record
+			 * @note Stub to libperf_sampler_parse()
+			 * @param const perf_event_header *const record - record obtained from next()
+			 * @return libperf_sample - decoded sample
+			 * @throws std::system_error - thrown if the record can't be decoded
+			 * @note Category of std::system_error will be libperf::Error
+			 */
+			libperf_sample parse(const perf_event_header *const record) const noexcept(false) ;
+
+			/**
+			 * @brief lost - method obtains how many records the kernel dropped as the ring buffer was full
+			 * @note Stub to libperf_sampler_lost()
+			 * @return std::uint64_t - number of records lost
+			 */
+			std::uint64_t lost() const noexcept ;
+
+			/**
+			 * @brief fd - method obtains the file descriptor of the sampled event, for use with poll()
+			 * @note Stub to libperf_sampler_fd()
+			 * @return int - file descriptor
+			 */
+			int fd() const noexcept ;
+
+			/**
+			 * @brief ~Sampler - shuts down the sampler
+			 * @note Stub to libperf_sampler_fini()
+			 */
+			~Sampler() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_SAMPLER_HPP
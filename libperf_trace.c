@@ -0,0 +1,541 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_trace.h"
+
+/**
+ * @brief Definitions of libperf timeline tracing API and inner functionality
+ * @author Salih MSA
+ */
+
+#define LIBPERF_TRACE_CACHE_LINE 64 // keeps producers' & consumer's indices from sharing a cache line
+#define LIBPERF_TRACE_PERIOD UINT64_C(10000000) // nanoseconds writer thread sleeps between draining the ring buffer
+#define LIBPERF_TRACE_BUFFER 1048576 // bytes of output stdio holds back before writing out
+
+struct libperf_trace_record { /* slot of ring buffer */
+	uint64_t sequence; // position in ring buffer this slot is next written (or, once one greater, read) at
+	uint64_t timestamp; // CLOCK_MONOTONIC, in nanoseconds
+	uint64_t duration; // length of span, in nanoseconds ('X' only)
+	const char *name; // name of span or thread
+	uint32_t tid; // thread recorded on
+	char phase; // Chrome trace event type: 'X' (complete span), 'C' (counter sample) or 'M' (thread name)
+	uint8_t count; // number of counters recorded
+	uint8_t events[LIBPERF_TRACE_VALUES]; // enum libperf_event of each counter recorded
+	uint64_t values[LIBPERF_TRACE_VALUES]; // value of each counter recorded
+};
+
+struct libperf_trace { /* lib struct */
+	/* written by producers (traced threads) */
+	uint64_t head __attribute__((aligned(LIBPERF_TRACE_CACHE_LINE))); // records claimed
+	uint64_t dropped; // records discarded as ring buffer was full
+
+	/* written by consumer (writer thread) */
+	uint64_t tail __attribute__((aligned(LIBPERF_TRACE_CACHE_LINE))); // records written out
+	uint64_t sampled_events; // mask of counters read by previous sample of sampled tracker
+	uint64_t sampled_values[LIBPERF_EVENT_SLOTS]; // raw values read by previous sample of sampled tracker
+	bool first; // whether no event has been written out yet, so needs no separating comma
+
+	/* fixed once opened */
+	FILE *file __attribute__((aligned(LIBPERF_TRACE_CACHE_LINE)));
+	char *buffer; // stdio buffer of file
+	pid_t pid; // process traced
+	uint64_t origin; // CLOCK_MONOTONIC when trace was opened, which timestamps are written relative to
+	libperf_tracker *sampled; // tracker sampled by writer thread, or NULL
+	uint64_t interval; // nanoseconds between samples of sampled
+	uint64_t capacity; // a power of two
+	struct libperf_trace_record *records; // ring buffer
+	pthread_t thread;
+	int stop; // set to ask writer thread to exit
+};
+
+static __thread uint32_t libperf_trace_thread_id; // calling thread's ID, cached as every record needs it
+
+static __thread struct { /* previous libperf_trace_counters() call of calling thread, which the next is measured from */
+	const libperf_trace *trace;
+	const libperf_tracker *pd;
+	uint64_t events; // mask of counters read
+	uint64_t values[LIBPERF_EVENT_SLOTS]; // raw values read
+} libperf_trace_baseline;
+
+static inline uint64_t libperf_trace_clock(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * UINT64_C(1000000000)) + (uint64_t)now.tv_nsec;
+}
+
+static inline uint32_t libperf_trace_tid(void)
+{
+	if (libperf_trace_thread_id == 0) {
+		libperf_trace_thread_id = (uint32_t)syscall(SYS_gettid);
+	}
+	return libperf_trace_thread_id;
+}
+
+/**
+ * @brief libperf_trace_fill - copies counters into a record, compacting them to the lowest numbered LIBPERF_TRACE_VALUES
+ * @param struct libperf_trace_record *const record - record to write out to
+ * @param const uint64_t events - mask of counters read
+ * @param const uint64_t *const values - raw values, indexed by enum libperf_event
+ * @param const uint64_t *const begin - values to subtract, indexed by enum libperf_event, or NULL
+ */
+static void libperf_trace_fill(struct libperf_trace_record *const record, const uint64_t events, const uint64_t *const values, const uint64_t *const begin)
+{
+	record->count = 0;
+	for (size_t i = 0; i < LIBPERF_EVENT_SLOTS && record->count < LIBPERF_TRACE_VALUES; ++i) {
+		if ((events & LIBPERF_EVENT_MASK(i)) == 0) {
+			continue;
+		}
+		record->events[record->count] = (uint8_t)i;
+		record->values[record->count] = begin == NULL ? values[i] : values[i] - begin[i];
+		++record->count;
+	}
+}
+
+/**
+ * @brief libperf_trace_push - appends a record to the ring buffer
+ * @note Safe to call from many threads at once: each claims a slot by advancing head, then publishes it through the slot's sequence
+ * @param libperf_trace *const trace - trace
+ * @param const struct libperf_trace_record *const record - record to copy in; its sequence is ignored
+ * @return bool - whether the record was appended, rather than dropped as the ring buffer was full
+ */
+static bool libperf_trace_push(libperf_trace *const trace, const struct libperf_trace_record *const record)
+{
+	uint64_t position = __atomic_load_n(&trace->head, __ATOMIC_RELAXED);
+	struct libperf_trace_record *slot;
+
+	for (;;) {
+		slot = &trace->records[position & (trace->capacity - 1)];
+		const uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE); // acquire pairs with consumer's release, so its copy out of the slot is done
+		const int64_t difference = (int64_t)(sequence - position);
+
+		if (difference == 0) { // slot free for this position, so try claiming it
+			if (__atomic_compare_exchange_n(&trace->head, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		} else if (difference < 0) { // slot still holds the record from a lap ago
+			__atomic_add_fetch(&trace->dropped, 1, __ATOMIC_RELAXED);
+			return false;
+		} else { // another producer claimed this position first
+			position = __atomic_load_n(&trace->head, __ATOMIC_RELAXED);
+		}
+	}
+
+	slot->timestamp = record->timestamp;
+	slot->duration = record->duration;
+	slot->name = record->name;
+	slot->tid = record->tid;
+	slot->phase = record->phase;
+	slot->count = record->count;
+	memcpy(slot->events, record->events, record->count * sizeof(record->events[0]));
+	memcpy(slot->values, record->values, record->count * sizeof(record->values[0]));
+
+	__atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE); // publish record; release pairs with consumer's acquire of sequence
+
+	return true;
+}
+
+/**
+ * @brief libperf_trace_string - writes out a string as a JSON string literal
+ * @param FILE *const file - file to write to
+ * @param const char *const string - string
+ */
+static void libperf_trace_string(FILE *const file, const char *const string)
+{
+	fputc('"', file);
+	for (const char *c = string; *c != '\0'; ++c) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', file);
+			fputc(*c, file);
+		} else if ((unsigned char)*c < 0x20) {
+			fprintf(file, "\\u%04x", (unsigned int)(unsigned char)*c);
+		} else {
+			fputc(*c, file);
+		}
+	}
+	fputc('"', file);
+}
+
+/**
+ * @brief libperf_trace_event - writes out a record as a Chrome trace event
+ * @param libperf_trace *const trace - trace
+ * @param const struct libperf_trace_record *const record - record
+ */
+static void libperf_trace_event(libperf_trace *const trace, const struct libperf_trace_record *const record)
+{
+	FILE *const file = trace->file;
+	const uint64_t elapsed = record->timestamp - trace->origin;
+
+	fputs(trace->first ? "\n" : ",\n", file);
+	trace->first = false;
+
+	/* timestamps are in microseconds, so keep nanoseconds as the fraction */
+	fputs("{\"ph\":\"", file);
+	fputc(record->phase, file);
+	fprintf(file, "\",\"ts\":%lu.%03lu,\"pid\":%d,\"tid\":%u", elapsed / 1000, elapsed % 1000, (int)trace->pid, record->tid);
+
+	switch (record->phase) {
+		case 'X':;
+			fprintf(file, ",\"dur\":%lu.%03lu,\"cat\":\"libperf\",\"name\":", record->duration / 1000, record->duration % 1000);
+			libperf_trace_string(file, record->name);
+			break;
+		case 'C':;
+			if (record->tid == 0) { // sampled by writer thread, so process wide
+				fputs(",\"name\":\"sampled_delta\"", file);
+			} else {
+				fprintf(file, ",\"name\":\"thread_delta\",\"id\":%u", record->tid);
+			}
+			break;
+		case 'M':;
+			fputs(",\"name\":\"thread_name\",\"args\":{\"name\":", file);
+			libperf_trace_string(file, record->name);
+			fputc('}', file);
+			break;
+		default:;
+			break;
+	}
+
+	if (record->phase != 'M' && record->count > 0) {
+		fputs(",\"args\":{", file);
+		for (size_t i = 0; i < record->count; ++i) {
+			const char *const event = libperf_event_name((enum libperf_event)record->events[i]);
+			fprintf(file, "%s\"%s\":%lu", i == 0 ? "" : ",", event == NULL ? "UNKNOWN" : event, record->values[i]);
+		}
+		fputc('}', file);
+	}
+
+	fputc('}', file);
+}
+
+/**
+ * @brief libperf_trace_drain - writes out every record in the ring buffer
+ * @param libperf_trace *const trace - trace
+ */
+static void libperf_trace_drain(libperf_trace *const trace)
+{
+	for (;;) {
+		const uint64_t position = trace->tail; // only the consumer writes tail
+		struct libperf_trace_record *const slot = &trace->records[position & (trace->capacity - 1)];
+		if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != position + 1) { // acquire pairs with producer's release, so the record is complete
+			return;
+		}
+
+		libperf_trace_event(trace, slot);
+
+		__atomic_store_n(&slot->sequence, position + trace->capacity, __ATOMIC_RELEASE); // hand slot back for the next lap; release pairs with producer's acquire
+		trace->tail = position + 1;
+	}
+}
+
+/**
+ * @brief libperf_trace_sample - writes out how far the sampled tracker's counters advanced since its previous sample
+ * @param libperf_trace *const trace - trace
+ */
+static void libperf_trace_sample(libperf_trace *const trace)
+{
+	uint64_t events;
+	uint64_t values[LIBPERF_EVENT_SLOTS];
+	if (libperf_read_enabled(trace->sampled, &events, values) != LIBPERF_EXIT_SUCCESS) {
+		return;
+	}
+
+	struct libperf_trace_record record;
+	record.timestamp = libperf_trace_clock();
+	record.duration = 0;
+	record.name = NULL;
+	record.tid = 0;
+	record.phase = 'C';
+
+	const uint64_t common = events & trace->sampled_events; // counters enabled since the previous sample have nothing to be compared against yet
+	if (common != 0) {
+		libperf_trace_fill(&record, common, values, trace->sampled_values);
+		libperf_trace_event(trace, &record);
+	}
+
+	trace->sampled_events = events;
+	memcpy(trace->sampled_values, values, sizeof(values));
+}
+
+/**
+ * @brief libperf_trace_run - body of writer thread
+ * @param void *const arg - trace
+ * @return void* - NULL
+ */
+static void *libperf_trace_run(void *const arg)
+{
+	libperf_trace *const trace = arg;
+
+	uint64_t next_sample = libperf_trace_clock() + trace->interval;
+	if (trace->sampled != NULL) { // baseline to measure the first interval from
+		libperf_trace_sample(trace);
+	}
+
+	while (!__atomic_load_n(&trace->stop, __ATOMIC_RELAXED)) {
+		libperf_trace_drain(trace);
+
+		uint64_t now = libperf_trace_clock();
+		if (trace->sampled != NULL && now >= next_sample) {
+			libperf_trace_sample(trace);
+			next_sample += trace->interval;
+			if (next_sample <= now) { // fell behind (e.g. descheduled), so skip the missed samples rather than bunch them up
+				next_sample = now + trace->interval;
+			}
+		}
+
+		/* wake at whichever comes first: the next drain or the next sample */
+		const uint64_t wake = trace->sampled != NULL && next_sample < now + LIBPERF_TRACE_PERIOD ? next_sample : now + LIBPERF_TRACE_PERIOD;
+		const struct timespec deadline = { (time_t)(wake / UINT64_C(1000000000)), (long)(wake % UINT64_C(1000000000)) };
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR);
+	}
+
+	libperf_trace_drain(trace);
+
+	return NULL;
+}
+
+libperf_trace *libperf_trace_open(const char *const path, const size_t capacity, libperf_tracker *const sampled, const uint64_t interval)
+{
+	if (path == NULL || capacity == 0 || (capacity & (capacity - 1)) != 0 || (sampled != NULL && interval == 0)) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid path, capacity or interval supplied", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (sampled != NULL && libperf_get_read_mode(sampled) != LIBPERF_READ_MODE_SYSCALL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): sampled trackers must be read with syscalls", __func__);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	libperf_trace *trace;
+	if (posix_memalign((void **)&trace, LIBPERF_TRACE_CACHE_LINE, sizeof(libperf_trace)) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for handle", __func__);
+		errno = ENOMEM;
+		return NULL;
+	}
+	memset(trace, 0, sizeof(libperf_trace));
+
+	trace->records = malloc(capacity * sizeof(struct libperf_trace_record));
+	trace->buffer = malloc(LIBPERF_TRACE_BUFFER);
+	if (trace->records == NULL || trace->buffer == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to allocate memory for buffers", __func__);
+		free(trace->buffer);
+		free(trace->records);
+		free(trace);
+		errno = ENOMEM;
+		return NULL;
+	}
+	for (size_t i = 0; i < capacity; ++i) { // slot i is first written at position i
+		trace->records[i].sequence = i;
+	}
+
+	trace->file = fopen(path, "we");
+	if (trace->file == NULL) {
+		const int err = errno;
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to open '%s'", __func__, path);
+		free(trace->buffer);
+		free(trace->records);
+		free(trace);
+		errno = err;
+		return NULL;
+	}
+	setvbuf(trace->file, trace->buffer, _IOFBF, LIBPERF_TRACE_BUFFER);
+
+	trace->pid = getpid();
+	trace->origin = libperf_trace_clock();
+	trace->sampled = sampled;
+	trace->interval = interval;
+	trace->capacity = capacity;
+	trace->first = true;
+
+	fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", trace->file);
+
+	/* writer thread inherits a fully blocked signal mask, so the application's handlers never run on it */
+	sigset_t all, previous;
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &previous);
+	const int err = pthread_create(&trace->thread, NULL, libperf_trace_run, trace);
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+	if (err != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to create writer thread", __func__);
+		fclose(trace->file);
+		unlink(path);
+		free(trace->buffer);
+		free(trace->records);
+		free(trace);
+		errno = err;
+		return NULL;
+	}
+
+	libperf_diag(LOG_INFO, "libperf (in %s): trace opened", __func__);
+	return trace;
+}
+
+enum libperf_exit libperf_trace_begin(libperf_trace *const trace, libperf_tracker *const pd, const char *const name, struct libperf_trace_span *const span)
+{
+	if (span != NULL) { // so a span which couldn't begin isn't ended either
+		span->name = NULL;
+	}
+
+	if (trace == NULL || name == NULL || span == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	enum libperf_exit rt = LIBPERF_EXIT_SUCCESS;
+	span->pd = pd;
+	span->events = 0;
+	if (pd != NULL) {
+		rt = libperf_read_enabled(pd, &span->events, span->values);
+		if (rt != LIBPERF_EXIT_SUCCESS) { // span is timed nonetheless
+			span->pd = NULL;
+			span->events = 0;
+		}
+	}
+
+	span->begin = libperf_trace_clock(); // taken after reading counters, so their cost lies outside the span
+	span->name = name;
+
+	return rt;
+}
+
+enum libperf_exit libperf_trace_end(libperf_trace *const trace, struct libperf_trace_span *const span)
+{
+	if (trace == NULL || span == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	if (span->name == NULL) { // never began
+		return LIBPERF_EXIT_SUCCESS;
+	}
+
+	/* written as one complete event, so a span is either recorded whole or dropped whole, never left open */
+	struct libperf_trace_record record;
+	record.timestamp = span->begin;
+	record.duration = libperf_trace_clock() - span->begin; // taken before reading counters, so their cost lies outside the span
+	record.name = span->name;
+	record.tid = libperf_trace_tid();
+	record.phase = 'X';
+	record.count = 0;
+
+	enum libperf_exit rt = LIBPERF_EXIT_SUCCESS;
+	if (span->pd != NULL) {
+		uint64_t events;
+		uint64_t values[LIBPERF_EVENT_SLOTS];
+		rt = libperf_read_enabled(span->pd, &events, values);
+		if (rt == LIBPERF_EXIT_SUCCESS) {
+			libperf_trace_fill(&record, events & span->events, values, span->values); // counters toggled within the span are left out
+		}
+	}
+
+	libperf_trace_push(trace, &record); // even if counters weren't read, so the span is timed nonetheless
+	span->name = NULL;
+
+	return rt;
+}
+
+enum libperf_exit libperf_trace_counters(libperf_trace *const trace, libperf_tracker *const pd)
+{
+	if (trace == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	uint64_t events;
+	uint64_t values[LIBPERF_EVENT_SLOTS];
+	const enum libperf_exit rt = libperf_read_enabled(pd, &events, values);
+	if (rt != LIBPERF_EXIT_SUCCESS) {
+		return rt;
+	}
+
+	/* as with the sampled track, samples are how far counters advanced since the previous one, so both kinds of counter track read alike */
+	const uint64_t common = libperf_trace_baseline.trace == trace && libperf_trace_baseline.pd == pd ? events & libperf_trace_baseline.events : 0;
+	if (common != 0) {
+		struct libperf_trace_record record;
+		record.timestamp = libperf_trace_clock();
+		record.duration = 0;
+		record.name = NULL;
+		record.tid = libperf_trace_tid();
+		record.phase = 'C';
+		libperf_trace_fill(&record, common, values, libperf_trace_baseline.values);
+
+		libperf_trace_push(trace, &record);
+	}
+
+	libperf_trace_baseline.trace = trace;
+	libperf_trace_baseline.pd = pd;
+	libperf_trace_baseline.events = events;
+	memcpy(libperf_trace_baseline.values, values, sizeof(values));
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+enum libperf_exit libperf_trace_thread_name(libperf_trace *const trace, const char *const name)
+{
+	if (trace == NULL || name == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return LIBPERF_EXIT_HANDLE_INVALID;
+	}
+
+	struct libperf_trace_record record;
+	record.timestamp = trace->origin; // metadata isn't placed on the timeline
+	record.duration = 0;
+	record.name = name;
+	record.tid = libperf_trace_tid();
+	record.phase = 'M';
+	record.count = 0;
+
+	libperf_trace_push(trace, &record);
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+uint64_t libperf_trace_dropped(const libperf_trace *const trace)
+{
+	if (trace == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return 0;
+	}
+
+	return __atomic_load_n(&trace->dropped, __ATOMIC_RELAXED);
+}
+
+void libperf_trace_close(libperf_trace *const trace)
+{
+	if (trace == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid handle", __func__);
+		return;
+	}
+
+	__atomic_store_n(&trace->stop, 1, __ATOMIC_RELAXED);
+	pthread_join(trace->thread, NULL);
+
+	fprintf(trace->file, "\n],\"otherData\":{\"clock\":\"CLOCK_MONOTONIC\",\"origin_ns\":%lu,\"dropped\":%lu}}\n", trace->origin, libperf_trace_dropped(trace));
+	const bool failed = ferror(trace->file) != 0;
+	if (fclose(trace->file) != 0 || failed) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unable to write out trace", __func__);
+	}
+
+	free(trace->buffer);
+	free(trace->records);
+	free(trace);
+
+	libperf_diag(LOG_NOTICE, "libperf (in %s): trace closed", __func__);
+}
@@ -0,0 +1,107 @@
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_trace.h"
+
+#include "libperf.hpp"
+#include "libperf_trace.hpp"
+
+/**
+ * @brief Definitions of libperf timeline tracing API in C++
+ * @author Salih MSA
+ */
+
+libperf::Trace::Trace(const char *const path, const std::size_t capacity) noexcept(false)
+{
+	this->_trace = libperf_trace_open(path, capacity, nullptr, 0) ;
+	if(this->_trace == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Trace::Trace(const char *const path, const std::size_t capacity, libperf::Tracker& sampled, const std::uint64_t interval) noexcept(false)
+{
+	this->_trace = libperf_trace_open(path, capacity, sampled.handle(), interval) ;
+	if(this->_trace == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Trace::Trace(libperf::Trace&& trace) noexcept
+{
+	this->_trace = trace._trace ;
+	trace._trace = nullptr ;
+}
+
+libperf::Trace& libperf::Trace::operator=(libperf::Trace&& trace) noexcept
+{
+	if(this != &trace)
+	{
+		if(this->_trace != nullptr)
+		{
+			libperf_trace_close(this->_trace) ;
+		}
+		this->_trace = trace._trace ;
+		trace._trace = nullptr ;
+	}
+
+	return *this ;
+}
+
+void libperf::Trace::counters(libperf::Tracker& tracker) noexcept(false)
+{
+	const auto err = libperf_trace_counters(this->_trace, tracker.handle()) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+void libperf::Trace::thread_name(const char *const name) noexcept
+{
+	libperf_trace_thread_name(this->_trace, name) ;
+}
+
+std::uint64_t libperf::Trace::dropped() const noexcept
+{
+	return libperf_trace_dropped(this->_trace) ;
+}
+
+libperf_trace* libperf::Trace::handle() const noexcept
+{
+	return this->_trace ;
+}
+
+libperf::Trace::~Trace() noexcept
+{
+	if(this->_trace != nullptr)
+	{
+		libperf_trace_close(this->_trace) ;
+	}
+}
+
+libperf::ScopedTrace::ScopedTrace(libperf::Trace& trace, const char *const name, const libperf::Tracker& tracker) noexcept : _trace(trace.handle())
+{
+	libperf_trace_begin(this->_trace, tracker.handle(), name, &this->_span) ;
+}
+
+libperf::ScopedTrace::ScopedTrace(libperf::Trace& trace, const char *const name) noexcept : _trace(trace.handle())
+{
+	libperf_trace_begin(this->_trace, nullptr, name, &this->_span) ;
+}
+
+libperf::ScopedTrace::~ScopedTrace() noexcept
+{
+	libperf_trace_end(this->_trace, &this->_span) ;
+}
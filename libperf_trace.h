@@ -0,0 +1,105 @@
+#ifndef LIBPERF_TRACE_H
+#define LIBPERF_TRACE_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "libperf.h"
+
+/**
+ * @brief Declarations of libperf timeline tracing API
+ * @note A trace writes spans (named regions of a thread's execution) and counter samples as a Chrome Trace Event JSON file, which chrome://tracing, Perfetto (ui.perfetto.dev) and speedscope open. Each thread gets its own track, each span carrying how far the tracker's counters advanced within it
+ * @note Threads only copy a fixed-size record into a ring buffer shared by all of them, without locking; a writer thread owned by the trace formats & writes records out, so file I/O never happens on traced threads
+ * @author Salih MSA
+ */
+
+struct libperf_trace;
+typedef struct libperf_trace libperf_trace;
+
+#define LIBPERF_TRACE_VALUES 8 // most counters recorded per span or sample, the lowest numbered of those enabled
+
+struct libperf_trace_span { /* span in progress, held by the caller between libperf_trace_begin() & libperf_trace_end() */
+	const char *name; // name of span, or NULL if it couldn't begin (so isn't written on ending either)
+	uint64_t begin; // CLOCK_MONOTONIC on entry, in nanoseconds
+	libperf_tracker *pd; // tracker read on entry, or NULL if none (or the read failed)
+	uint64_t events; // mask (see LIBPERF_EVENT_MASK) of counters read on entry
+	uint64_t values[LIBPERF_EVENT_SLOTS]; // raw values on entry, indexed by enum libperf_event
+};
+
+/**
+ * @brief libperf_trace_open - function creates (or truncates) a trace file, starting its writer thread
+ * @param const char *const path - path of file to write to, conventionally ending .json
+ * @param const size_t capacity - number of records the ring buffer holds; must be a power of two. When full, new records are dropped (see libperf_trace_dropped())
+ * @param libperf_tracker *const sampled - tracker the writer thread samples every interval onto a process wide counter track ("sampled_delta") of how far its counters advanced each interval, or NULL for none
+ * @pre sampled must use LIBPERF_READ_MODE_SYSCALL (see libperf_set_read_mode()), and outlive the trace
+ * @param const uint64_t interval - time between samples of sampled, in nanoseconds
+ * @return libperf_trace* - handle for use in future library calls
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_trace *libperf_trace_open(const char *const path, const size_t capacity, libperf_tracker *const sampled, const uint64_t interval);
+
+/**
+ * @brief libperf_trace_begin - function begins a span on the calling thread's track
+ * @note Nothing is recorded until the span ends, when it is written as a single (complete) event; should that be dropped, the span is missing as a whole
+ * @note Spans on a thread must nest, ie end in the reverse order they began
+ * @param libperf_trace *const trace - handle obtained from libperf_trace_open()
+ * @param libperf_tracker *const pd - tracker monitoring the calling thread, whose enabled counters are read (see libperf_read_enabled()), or NULL to record timing only
+ * @param const char *const name - name of span, which must outlive the trace (e.g. a string literal)
+ * @param struct libperf_trace_span *const span - span to pass to libperf_trace_end()
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); should the tracker not be read, the span is still recorded, just without counters
+ */
+enum libperf_exit libperf_trace_begin(libperf_trace *const trace, libperf_tracker *const pd, const char *const name, struct libperf_trace_span *const span);
+
+/**
+ * @brief libperf_trace_end - function ends a span, recording it with its duration & how far its counters advanced since it began
+ * @param libperf_trace *const trace - handle obtained from libperf_trace_open()
+ * @param struct libperf_trace_span *const span - span filled in by libperf_trace_begin()
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_trace_end(libperf_trace *const trace, struct libperf_trace_span *const span);
+
+/**
+ * @brief libperf_trace_counters - function records how far a tracker's enabled counters advanced since the calling thread's previous call, on its counter track ("thread_delta")
+ * @note The first call on a thread (or with another trace or tracker than its previous call) only takes a baseline, recording nothing
+ * @param libperf_trace *const trace - handle obtained from libperf_trace_open()
+ * @param libperf_tracker *const pd - tracker to read (see libperf_read_enabled())
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_trace_counters(libperf_trace *const trace, libperf_tracker *const pd);
+
+/**
+ * @brief libperf_trace_thread_name - function names the calling thread's track
+ * @param libperf_trace *const trace - handle obtained from libperf_trace_open()
+ * @param const char *const name - name of thread, which must outlive the trace (e.g. a string literal)
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code)
+ */
+enum libperf_exit libperf_trace_thread_name(libperf_trace *const trace, const char *const name);
+
+/**
+ * @brief libperf_trace_dropped - function obtains how many records were discarded as the ring buffer was full
+ * @param const libperf_trace *const trace - handle obtained from libperf_trace_open()
+ * @return uint64_t - number of records dropped
+ */
+uint64_t libperf_trace_dropped(const libperf_trace *const trace);
+
+/**
+ * @brief libperf_trace_close - function stops & joins the writer thread, writing out remaining records & completing the file
+ * @pre No other thread may still be recording into the trace
+ * @note Blocks for up to one writer period, plus the time to write out remaining records
+ * @param libperf_trace *const trace - handle obtained from libperf_trace_open()
+ */
+void libperf_trace_close(libperf_trace *const trace);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_TRACE_H
@@ -0,0 +1,151 @@
+#ifndef LIBPERF_TRACE_HPP
+#define LIBPERF_TRACE_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "libperf.hpp"
+#include "libperf_trace.h"
+
+/**
+ * @brief Declarations of libperf timeline tracing API for C++
+ * @note Access to traces in C++ in via an RAII-complaint container, with spans recorded by ScopedTrace
+ * @author Salih MSA
+ */
+
+#define LIBPERF_TRACE_CONCAT_(a, b) a##b
+#define LIBPERF_TRACE_CONCAT(a, b) LIBPERF_TRACE_CONCAT_(a, b)
+
+/**
+ * @brief LIBPERF_SCOPED_TRACE - records the rest of the enclosing scope as a span
+ * @param trace - libperf::Trace
+ * @param name - name of span (a string literal)
+ * @param tracker - libperf::Tracker monitoring the calling thread
+ */
+#define LIBPERF_SCOPED_TRACE(trace, name, tracker) \
+	const libperf::ScopedTrace LIBPERF_TRACE_CONCAT(libperf_scoped_trace_, __LINE__)(trace, name, tracker)
+
+namespace libperf {
+
+	class Trace {
+		private:
+			libperf_trace* _trace ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief Trace (constructor) - creates a trace file, starting its writer thread
+			 * @note Stub to libperf_trace_open()
+			 * @param const char *const path - path of file to write to
+			 * @param const std::size_t capacity - number of records the ring buffer holds; must be a power of two
+			 * @throws std::system_error - thrown if the trace couldn't be opened, with the errno which caused it
+			 */
+			explicit Trace(const char *const path, const std::size_t capacity) noexcept(false) ;
+
+			/**
+			 * @brief Trace (constructor) - creates a trace file, starting its writer thread which also samples a tracker
+			 * @note Stub to libperf_trace_open()
+			 * @pre sampled must use libperf_read_mode::LIBPERF_READ_MODE_SYSCALL, and outlive the trace
+			 * @param const char *const path - path of file to write to
+			 * @param const std::size_t capacity - number of records the ring buffer holds; must be a power of two
+			 * @param Tracker& sampled - tracker to sample onto a process wide counter track
+			 * @param const std::uint64_t interval - time between samples, in nanoseconds
+			 * @throws std::system_error - thrown if the trace couldn't be opened, with the errno which caused it
+			 */
+			explicit Trace(const char *const path, const std::size_t capacity, Tracker& sampled, const std::uint64_t interval) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as there's one writer thread
+			 */
+			Trace(const Trace& trace) noexcept(false) = delete ;
+			Trace& operator=(const Trace& trace) noexcept(false) = delete ;
+
+			/**
+			 * @brief Trace (move constructor) - acquire existing trace
+			 * @param Trace&& trace - trace to acquire
+			 */
+			explicit Trace(Trace&& trace) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing trace, closing the one held
+			 * @param Trace&& trace - trace to acquire
+			 * @return Trace& - object which acquired
+			 */
+			Trace& operator=(Trace&& trace) noexcept ;
+
+			/**
+			 * @brief counters - method records how far a tracker's enabled counters advanced since the calling thread's previous call, on its counter track
+			 * @note Stub to libperf_trace_counters()
+			 * @param Tracker& tracker - tracker to read
+			 * @throws std::system_error - thrown if the tracker couldn't be read
+			 */
+			void counters(Tracker& tracker) noexcept(false) ;
+
+			/**
+			 * @brief thread_name - method names the calling thread's track
+			 * @note Stub to libperf_trace_thread_name()
+			 * @param const char *const name - name of thread, which must outlive the trace (e.g. a string literal)
+			 */
+			void thread_name(const char *const name) noexcept ;
+
+			/**
+			 * @brief dropped - method obtains how many records were discarded as the ring buffer was full
+			 * @note Stub to libperf_trace_dropped()
+			 * @return std::uint64_t - number of records dropped
+			 */
+			std::uint64_t dropped() const noexcept ;
+
+			/**
+			 * @brief handle - method obtains the internal C API object, for use with libperf_trace_begin() etc.
+			 * @return libperf_trace* - handle
+			 */
+			libperf_trace* handle() const noexcept ;
+
+			/**
+			 * @brief ~Trace - stops the writer thread, completing the file
+			 * @note Stub to libperf_trace_close()
+			 */
+			~Trace() noexcept ;
+
+	} ;
+
+	class ScopedTrace {
+		private:
+			libperf_trace* _trace ;
+			libperf_trace_span _span ;
+
+		public:
+			/**
+			 * @brief ScopedTrace (constructor) - begins a span, reading the tracker's counters
+			 * @note Stub to libperf_trace_begin(); doesn't throw, the span being recorded without counters should the tracker not be read
+			 * @param Trace& trace - trace to record into
+			 * @param const char *const name - name of span, which must outlive the trace (e.g. a string literal)
+			 * @param const Tracker& tracker - tracker monitoring the calling thread
+			 */
+			explicit ScopedTrace(Trace& trace, const char *const name, const Tracker& tracker) noexcept ;
+
+			/**
+			 * @brief ScopedTrace (constructor) - begins a span, recording timing only
+			 * @note Stub to libperf_trace_begin()
+			 * @param Trace& trace - trace to record into
+			 * @param const char *const name - name of span, which must outlive the trace (e.g. a string literal)
+			 */
+			explicit ScopedTrace(Trace& trace, const char *const name) noexcept ;
+
+			/**
+			 * @note Copy & move deleted, as a span is ended exactly once
+			 */
+			ScopedTrace(const ScopedTrace& scoped) = delete ;
+			ScopedTrace& operator=(const ScopedTrace& scoped) = delete ;
+
+			/**
+			 * @brief ~ScopedTrace - ends the span, recording how far the counters advanced
+			 * @note Stub to libperf_trace_end()
+			 */
+			~ScopedTrace() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_TRACE_HPP
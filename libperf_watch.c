@@ -0,0 +1,81 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <errno.h>
+#include <sys/types.h>
+
+#include <linux/hw_breakpoint.h>
+#include <linux/perf_event.h>
+
+#include "libperf.h"
+#include "libperf_diag.h"
+#include "libperf_sampler.h"
+#include "libperf_watch.h"
+
+/**
+ * @brief Definitions of libperf watchpoint API and inner functionality
+ * @author Salih MSA
+ */
+
+enum libperf_exit libperf_watch_attr(const void *const address, const size_t length, const enum libperf_watch_access access, const uint64_t sample_type, struct perf_event_attr *const attr)
+{
+	if (attr == NULL) {
+		libperf_diag(LOG_ERR, "libperf (in %s): invalid attributes supplied", __func__);
+		return LIBPERF_EXIT_COUNTER_INVALID;
+	}
+	if (length != HW_BREAKPOINT_LEN_1 && length != HW_BREAKPOINT_LEN_2 && length != HW_BREAKPOINT_LEN_4 && length != HW_BREAKPOINT_LEN_8) {
+		libperf_diag(LOG_ERR, "libperf (in %s): watchpoints span 1, 2, 4 or 8 bytes", __func__);
+		return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+	if (((uintptr_t)address & (length - 1)) != 0) { // debug registers only match naturally aligned ranges
+		libperf_diag(LOG_ERR, "libperf (in %s): watched address must be aligned to its length", __func__);
+		return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+	if ((access != LIBPERF_WATCH_READ && access != LIBPERF_WATCH_WRITE && access != LIBPERF_WATCH_RW) || (sample_type & ~(uint64_t)LIBPERF_SAMPLE_SUPPORTED) != 0) {
+		libperf_diag(LOG_ERR, "libperf (in %s): unsupported configuration supplied", __func__);
+		return LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED;
+	}
+
+	memset(attr, 0, sizeof(struct perf_event_attr));
+	attr->size = sizeof(struct perf_event_attr);
+	attr->type = PERF_TYPE_BREAKPOINT;
+	attr->bp_type = (uint32_t)access;
+	attr->bp_addr = (uint64_t)(uintptr_t)address;
+	attr->bp_len = length;
+	attr->exclude_kernel = 1;
+	attr->exclude_hv = 1;
+
+	if (sample_type != 0) { // a breakpoint trapping is a single event, so sample each
+		attr->sample_period = 1;
+		attr->sample_type = sample_type;
+	}
+
+	return LIBPERF_EXIT_SUCCESS;
+}
+
+libperf_tracker *libperf_watch_count(const pid_t id, const int cpu, const void *const address, const size_t length, const enum libperf_watch_access access)
+{
+	struct perf_event_attr attr;
+	if (libperf_watch_attr(address, length, access, 0, &attr) != LIBPERF_EXIT_SUCCESS) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return libperf_init_explicit(id, cpu, &attr, 1, LIBPERF_INIT_DEFAULT);
+}
+
+libperf_sampler *libperf_watch_sample(const pid_t id, const int cpu, const void *const address, const size_t length, const enum libperf_watch_access access, const uint64_t sample_type, const size_t pages)
+{
+	struct perf_event_attr attr;
+	if (sample_type == 0 || libperf_watch_attr(address, length, access, sample_type, &attr) != LIBPERF_EXIT_SUCCESS) {
+		errno = EINVAL;
+		return NULL;
+	}
+	attr.disabled = 1; // specifics: as with other samplers, disabled by default
+
+	return libperf_sampler_init_attr(id, cpu, &attr, pages);
+}
@@ -0,0 +1,100 @@
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <cerrno>
+
+#include "libperf.h"
+#include "libperf_watch.h"
+
+#include "libperf.hpp"
+#include "libperf_watch.hpp"
+
+/**
+ * @brief Definitions of libperf watchpoint API in C++
+ * @author Salih MSA
+ */
+
+perf_event_attr libperf::watch_attr(const void *const address, const std::size_t length, const libperf_watch_access access, const std::uint64_t sample_type) noexcept(false)
+{
+	perf_event_attr attr ;
+
+	const auto err = libperf_watch_attr(address, length, access, sample_type, &attr) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		throw std::system_error(err, libperf::Error()) ;
+	}
+
+	return attr ;
+}
+
+libperf::Watchpoint::Watchpoint(const pid_t pid, const int cpu, const void *const address, const std::size_t length, const libperf_watch_access access) noexcept(false)
+{
+	this->_tracker = libperf_watch_count(pid, cpu, address, length, access) ;
+	if(this->_tracker == nullptr)
+	{
+		throw std::system_error(errno, std::generic_category()) ;
+	}
+}
+
+libperf::Watchpoint::Watchpoint(libperf::Watchpoint&& watchpoint) noexcept
+{
+	this->_tracker = watchpoint._tracker ;
+	watchpoint._tracker = nullptr ;
+}
+
+libperf::Watchpoint& libperf::Watchpoint::operator=(libperf::Watchpoint&& watchpoint) noexcept
+{
+	if(this != &watchpoint)
+	{
+		if(this->_tracker != nullptr)
+		{
+			libperf_fini(this->_tracker) ;
+		}
+		this->_tracker = watchpoint._tracker ;
+		watchpoint._tracker = nullptr ;
+	}
+
+	return *this ;
+}
+
+void libperf::Watchpoint::toggle(const libperf_event_toggle toggle_type) noexcept(false)
+{
+	const auto err = libperf_toggle_counter(this->_tracker, LIBPERF_EVENT_CUSTOM_N(0), toggle_type) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+}
+
+std::uint64_t libperf::Watchpoint::count() const noexcept(false)
+{
+	std::uint64_t value = 0 ;
+
+	const auto err = libperf_read_counter(this->_tracker, LIBPERF_EVENT_CUSTOM_N(0), &value) ;
+	if(err != LIBPERF_EXIT_SUCCESS)
+	{
+		if(err == LIBPERF_EXIT_SYSTEM_ERROR)
+		{
+			throw std::system_error(errno, std::generic_category()) ;
+		}
+		else {
+			throw std::system_error(err, libperf::Error()) ;
+		}
+	}
+
+	return value ;
+}
+
+libperf::Watchpoint::~Watchpoint() noexcept
+{
+	if(this->_tracker != nullptr)
+	{
+		libperf_fini(this->_tracker) ;
+	}
+}
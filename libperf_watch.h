@@ -0,0 +1,80 @@
+#ifndef LIBPERF_WATCH_H
+#define LIBPERF_WATCH_H
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h> // needed for boolean support
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <linux/hw_breakpoint.h>
+#include <linux/perf_event.h>
+
+#include "libperf.h"
+#include "libperf_sampler.h"
+
+/**
+ * @brief Declarations of libperf watchpoint API
+ * @note A watchpoint is a hardware breakpoint on data: the CPU traps whenever an address is read and/or written, letting the kernel count the accesses or sample who made them (e.g. the IP & TID of unexpected writers of a shared counter)
+ * @note Debug registers are scarce (4 on x86, shared with debuggers), and each covers at most 8 aligned bytes, so watch the hot word(s) rather than a whole cache line
+ * @author Salih MSA
+ */
+
+enum libperf_watch_access {
+	LIBPERF_WATCH_READ = HW_BREAKPOINT_R, // loads; x86 can't watch loads alone, use LIBPERF_WATCH_RW there
+	LIBPERF_WATCH_WRITE = HW_BREAKPOINT_W, // stores
+	LIBPERF_WATCH_RW = HW_BREAKPOINT_RW // loads & stores
+};
+
+/**
+ * @brief libperf_watch_attr - function creates the attributes of a watchpoint, for use with libperf_init_explicit() or libperf_sampler_init_attr()
+ * @note Only userspace accesses are watched (exclude_kernel & exclude_hv set); clear exclude_kernel to also catch the kernel's (e.g. copy_to_user()), privileges permitting
+ * @param const void *const address - start of data to watch
+ * @param const size_t length - bytes to watch: 1, 2, 4 or 8, with address aligned to it
+ * @param const enum libperf_watch_access access - accesses to watch
+ * @param const uint64_t sample_type - 0 to count accesses, otherwise bitwise OR of PERF_SAMPLE_* fields to record on every access (must be within LIBPERF_SAMPLE_SUPPORTED, e.g. PERF_SAMPLE_IP | PERF_SAMPLE_TID)
+ * @param struct perf_event_attr *const attr - attributes to write out to
+ * @return enum libperf_exit - exit code (see enum libperf_exit_code); LIBPERF_EXIT_COUNTER_CONFIGURATION_UNSUPPORTED if the length, alignment, access or sample type can't be watched; LIBPERF_EXIT_COUNTER_INVALID if attr is NULL
+ */
+enum libperf_exit libperf_watch_attr(const void *const address, const size_t length, const enum libperf_watch_access access, const uint64_t sample_type, struct perf_event_attr *const attr);
+
+/**
+ * @brief libperf_watch_count - function places a watchpoint counting accesses
+ * @note Read with libperf_read_counter(pd, LIBPERF_EVENT_CUSTOM_N(0), ...), once enabled with libperf_toggle_counter()
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @note Set -1 for system wide readings (address is then that of whichever process is running)
+ * @param const int cpu - pass in specific cpuid to track
+ * @note Set -1 for aggregate readings (of all CPUs)
+ * @param const void *const address - start of data to watch
+ * @param const size_t length - bytes to watch: 1, 2, 4 or 8, with address aligned to it
+ * @param const enum libperf_watch_access access - accesses to watch
+ * @return libperf_tracker* - handle for use in future library calls, initially disabled
+ * @note return NULL if failure occurs (e.g. ENOSPC if no debug registers are free), with errno set to the cause
+ */
+libperf_tracker *libperf_watch_count(const pid_t id, const int cpu, const void *const address, const size_t length, const enum libperf_watch_access access);
+
+/**
+ * @brief libperf_watch_sample - function places a watchpoint sampling every access
+ * @note Decode records with libperf_sampler_next() & libperf_sampler_parse(), once enabled with libperf_sampler_toggle()
+ * @param const pid_t id - process ID *or* thread ID to monitor
+ * @param const int cpu - pass in specific cpuid to track
+ * @param const void *const address - start of data to watch
+ * @param const size_t length - bytes to watch: 1, 2, 4 or 8, with address aligned to it
+ * @param const enum libperf_watch_access access - accesses to watch
+ * @param const uint64_t sample_type - bitwise OR of PERF_SAMPLE_* fields to record; must be within LIBPERF_SAMPLE_SUPPORTED
+ * @param const size_t pages - size of ring buffer in pages; must be a power of two
+ * @return libperf_sampler* - handle for use in future library calls, initially disabled
+ * @note return NULL if failure occurs, with errno set to the cause
+ */
+libperf_sampler *libperf_watch_sample(const pid_t id, const int cpu, const void *const address, const size_t length, const enum libperf_watch_access access, const uint64_t sample_type, const size_t pages);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBPERF_WATCH_H
@@ -0,0 +1,97 @@
+#ifndef LIBPERF_WATCH_HPP
+#define LIBPERF_WATCH_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+#include "libperf.hpp"
+#include "libperf_watch.h"
+
+/**
+ * @brief Declarations of libperf watchpoint API for C++
+ * @note Access to watchpoints in C++ in via an RAII-complaint container; to sample accesses instead, construct a libperf::Sampler with watch_attr()
+ * @author Salih MSA
+ */
+
+namespace libperf {
+
+	/**
+	 * @brief watch_attr - creates the attributes of a watchpoint, for use with the explicit Tracker constructor or libperf::Sampler
+	 * @note Stub to libperf_watch_attr()
+	 * @param const void *const address - start of data to watch
+	 * @param const std::size_t length - bytes to watch: 1, 2, 4 or 8, with address aligned to it
+	 * @param const libperf_watch_access access - accesses to watch
+	 * @param const std::uint64_t sample_type - 0 to count accesses, otherwise PERF_SAMPLE_* fields to record on every access
+	 * @return perf_event_attr - attributes of watchpoint
+	 * @throws std::system_error - thrown if the watchpoint can't be described
+	 * @note Category of std::system_error will be libperf::Error
+	 */
+	perf_event_attr watch_attr(const void *const address, const std::size_t length, const libperf_watch_access access, const std::uint64_t sample_type = 0) noexcept(false) ;
+
+	class Watchpoint {
+		private:
+			libperf_tracker* _tracker ; // internal, opaque C API object
+
+		public:
+			/**
+			 * @brief Watchpoint (constructor) - places a watchpoint counting accesses, initially disabled
+			 * @note Stub to libperf_watch_count()
+			 * @param const pid_t pid - process ID *or* thread ID to monitor
+			 * @param const int cpu - pass in specific cpuid to track
+			 * @param const void *const address - start of data to watch
+			 * @param const std::size_t length - bytes to watch: 1, 2, 4 or 8, with address aligned to it
+			 * @param const libperf_watch_access access - accesses to watch
+			 * @throws std::system_error - thrown if the watchpoint couldn't be placed, with the errno which caused it
+			 */
+			explicit Watchpoint(const pid_t pid, const int cpu, const void *const address, const std::size_t length, const libperf_watch_access access) noexcept(false) ;
+
+			/**
+			 * @note Copy constructor + assignment deleted, as a debug register can't be shared
+			 */
+			Watchpoint(const Watchpoint& watchpoint) noexcept(false) = delete ;
+			Watchpoint& operator=(const Watchpoint& watchpoint) noexcept(false) = delete ;
+
+			/**
+			 * @brief Watchpoint (move constructor) - acquire existing watchpoint
+			 * @param Watchpoint&& watchpoint - watchpoint to acquire
+			 */
+			explicit Watchpoint(Watchpoint&& watchpoint) noexcept ;
+
+			/**
+			 * @brief operator= (move assignment) - acquire existing watchpoint, removing the one held
+			 * @param Watchpoint&& watchpoint - watchpoint to acquire
+			 * @return Watchpoint& - object which acquired
+			 */
+			Watchpoint& operator=(Watchpoint&& watchpoint) noexcept ;
+
+			/**
+			 * @brief toggle - method enables, disables or resets the watchpoint
+			 * @note Stub to libperf_toggle_counter()
+			 * @param const libperf_event_toggle toggle_type - one of LIBPERF_EVENT_TOGGLE_ON, LIBPERF_EVENT_TOGGLE_OFF or LIBPERF_EVENT_TOGGLE_RESET
+			 * @throws std::system_error - thrown if we can't manipulate the watchpoint
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error, depending on the underlying C API
+			 */
+			void toggle(const libperf_event_toggle toggle_type) noexcept(false) ;
+
+			/**
+			 * @brief count - method reads how many accesses were made
+			 * @note Stub to libperf_read_counter()
+			 * @return std::uint64_t - number of accesses
+			 * @throws std::system_error - thrown if the watchpoint couldn't be read
+			 * @note Category of std::system_error will either be std::generic_category, or libperf::Error, depending on the underlying C API
+			 */
+			std::uint64_t count() const noexcept(false) ;
+
+			/**
+			 * @brief ~Watchpoint - removes the watchpoint
+			 * @note Stub to libperf_fini()
+			 */
+			~Watchpoint() noexcept ;
+
+	} ;
+
+} // libperf
+
+#endif // LIBPERF_WATCH_HPP
@@ -0,0 +1,143 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+#include "libperf_binlog.h"
+
+/**
+ * @brief libperf-decode - converts a binary log (see libperf_binlog.h) to text or CSV
+ * @note Usage: libperf-decode [-c] <log>, writing to stdout. Text mirrors libperf_log(); CSV has a row per record, leaving values which weren't read empty
+ * @author Salih MSA
+ */
+
+static void usage(const char *const program)
+{
+	fprintf(stderr, "usage: %s [-c] <log>\n\t-c\toutput CSV rather than text\n", program);
+}
+
+int main(int argc, char *argv[])
+{
+	int csv = 0;
+	int option;
+	while ((option = getopt(argc, argv, "ch")) != -1) {
+		switch (option) {
+			case 'c':;
+				csv = 1;
+				break;
+			default:;
+				usage(argv[0]);
+				return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (optind != argc - 1) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	FILE *const input = fopen(argv[optind], "rb");
+	if (input == NULL) {
+		perror(argv[optind]);
+		return EXIT_FAILURE;
+	}
+
+	struct libperf_binlog_header header;
+	if (fread(&header, sizeof(header), 1, input) != 1 || memcmp(header.magic, LIBPERF_BINLOG_MAGIC, sizeof(header.magic)) != 0) {
+		fprintf(stderr, "%s: not a libperf binary log\n", argv[optind]);
+		fclose(input);
+		return EXIT_FAILURE;
+	}
+
+	if (header.version != LIBPERF_BINLOG_VERSION || header.count == 0 || header.count > 64) {
+		fprintf(stderr, "%s: unsupported version %u of libperf binary log\n", argv[optind], header.version);
+		fclose(input);
+		return EXIT_FAILURE;
+	}
+
+	if ((int)header.count != __builtin_popcountll(header.events)) { // values per record would be misread
+		fprintf(stderr, "%s: corrupt header, %u events logged but mask holds %d\n", argv[optind], header.count, __builtin_popcountll(header.events));
+		fclose(input);
+		return EXIT_FAILURE;
+	}
+
+	char names[64][LIBPERF_BINLOG_NAME_SIZE];
+	uint64_t masks[64]; // mask of each logged event, in the order values are stored
+	uint64_t remaining = header.events;
+	for (uint32_t i = 0; i < header.count; ++i) {
+		if (fread(names[i], LIBPERF_BINLOG_NAME_SIZE, 1, input) != 1) {
+			fprintf(stderr, "%s: truncated header\n", argv[optind]);
+			fclose(input);
+			return EXIT_FAILURE;
+		}
+		names[i][LIBPERF_BINLOG_NAME_SIZE - 1] = '\0';
+		masks[i] = remaining & (~remaining + 1); // lowest set bit
+		remaining &= remaining - 1;
+	}
+
+	if (csv) {
+		printf("tag,timestamp");
+		for (uint32_t i = 0; i < header.count; ++i) {
+			printf(",%s", names[i]);
+		}
+		printf("\n");
+	}
+
+	const size_t record_size = sizeof(struct libperf_binlog_record) + (header.count * sizeof(uint64_t));
+	uint64_t buffer[3 + 64];
+	struct libperf_binlog_record *const record = (struct libperf_binlog_record *)buffer;
+	const uint64_t *const values = (const uint64_t *)(record + 1);
+
+	int status = EXIT_SUCCESS;
+	size_t read;
+	while ((read = fread(buffer, 1, record_size, input)) == record_size) {
+		if ((record->events & ~header.events) != 0) { // record claims events the log doesn't hold, so isn't laid out as the header says
+			fprintf(stderr, "%s: corrupt record (tag %lu) reading events outside those logged\n", argv[optind], record->tag);
+			status = EXIT_FAILURE;
+			break;
+		}
+
+		/* wall clock time the record was written at */
+		const uint64_t timestamp = header.realtime + (record->timestamp - header.monotonic);
+		const uint64_t seconds = timestamp / UINT64_C(1000000000);
+		const uint64_t nanoseconds = timestamp % UINT64_C(1000000000);
+
+		if (csv) {
+			printf("%lu,%lu.%09lu", record->tag, seconds, nanoseconds);
+			for (uint32_t i = 0; i < header.count; ++i) {
+				if (record->events & masks[i]) {
+					printf(",%lu", values[i]);
+				} else {
+					printf(",");
+				}
+			}
+			printf("\n");
+		} else {
+			for (uint32_t i = 0; i < header.count; ++i) {
+				if (record->events & masks[i]) {
+					printf("%s[%lu]: %lu\n", names[i], record->tag, values[i]);
+				}
+			}
+			printf("TIMESTAMP[%lu]: %lu.%09lu\n", record->tag, seconds, nanoseconds);
+		}
+	}
+
+	if (ferror(input)) {
+		perror(argv[optind]);
+		fclose(input);
+		return EXIT_FAILURE;
+	}
+
+	if (status == EXIT_SUCCESS && read != 0 && read != record_size) {
+		fprintf(stderr, "%s: truncated record at end of log\n", argv[optind]);
+		status = EXIT_FAILURE;
+	}
+
+	fclose(input);
+	return status;
+}
@@ -0,0 +1,401 @@
+#define _POSIX_C_SOURCE 199309L
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <linux/perf_event.h>
+
+#include "libperf.h"
+#include "libperf_pmu.h"
+
+/**
+ * @brief libperf-stat - runs a command, counting events over it
+ * @note Usage: libperf-stat [-e events]... [-r runs] [-g] [-c | -j] [-o file] [--] <command> [args...]. Counters are opened on the child before it execs the command, enabling themselves at the exec, so none of the launcher is counted. Results (mean & standard deviation across runs) go to stderr unless -o is given; the exit status is that of the command's last run
+ * @author Salih MSA
+ */
+
+#define LIBPERF_STAT_NAME 256 // longest event description
+
+enum libperf_stat_format {
+	LIBPERF_STAT_TEXT = 0,
+	LIBPERF_STAT_CSV = 1,
+	LIBPERF_STAT_JSON = 2
+};
+
+struct libperf_stat_event {
+	char name[LIBPERF_STAT_NAME]; // as given by the user
+	struct perf_event_attr attr;
+	uint64_t runs; // runs the event was counted in
+	double mean; // running mean & sum of squared deviations (Welford's method)
+	double m2;
+	double running; // sum of the fraction of time counted for, less than runs if multiplexed
+};
+
+struct libperf_stat_statistic {
+	uint64_t runs;
+	double mean;
+	double m2;
+};
+
+static const enum libperf_event libperf_stat_defaults[] = {
+	LIBPERF_EVENT_SW_TASK_CLOCK, LIBPERF_EVENT_SW_CONTEXT_SWITCHES, LIBPERF_EVENT_SW_CPU_MIGRATIONS, LIBPERF_EVENT_SW_PAGE_FAULTS,
+	LIBPERF_EVENT_HW_CPU_CYCLES, LIBPERF_EVENT_HW_INSTRUCTIONS, LIBPERF_EVENT_HW_BRANCH_INSTRUCTIONS, LIBPERF_EVENT_HW_BRANCH_MISSES
+};
+
+static void usage(const char *const program)
+{
+	fprintf(stderr, "usage: %s [-e events]... [-r runs] [-g] [-c | -j] [-o file] [--] <command> [args...]\n"
+		"\t-e\tcomma separated events: libperf's (e.g. HW_INSTRUCTIONS), or as perf names them (e.g. cpu/event=0xc0/, sched:sched_switch)\n"
+		"\t-r\trun the command this many times, reporting mean & standard deviation\n"
+		"\t-g\tcount events as one group, so they're always measured over the same interval\n"
+		"\t-c\toutput CSV rather than text\n"
+		"\t-j\toutput JSON rather than text\n"
+		"\t-o\twrite results to file rather than stderr\n", program);
+}
+
+/**
+ * @brief libperf_stat_resolve - translates an event description into attributes
+ * @param const char *const name - libperf event name (e.g. HW_INSTRUCTIONS), or any description libperf_pmu_parse() accepts
+ * @param struct perf_event_attr *const attr - attributes to write out to
+ * @return int - 0 on success, -1 if the event is unknown
+ */
+static int libperf_stat_resolve(const char *const name, struct perf_event_attr *const attr)
+{
+	for (int i = 0; i < LIBPERF_LIB_SW_WALL_TIME; ++i) {
+		if (strcasecmp(name, libperf_event_name((enum libperf_event)i)) == 0) {
+			return libperf_event_attr((enum libperf_event)i, attr) == LIBPERF_EXIT_SUCCESS ? 0 : -1;
+		}
+	}
+
+	return libperf_pmu_parse(name, attr) == LIBPERF_EXIT_SUCCESS ? 0 : -1;
+}
+
+/**
+ * @brief libperf_stat_add - adds comma separated events, bar commas within a PMU's terms (e.g. cpu/event=0xd1,umask=0x20/)
+ * @param const char *const list - events
+ * @param struct libperf_stat_event *const events - events to append to
+ * @param size_t *const count - number of events, updated
+ * @return int - 0 on success, -1 if an event is unknown or there are too many
+ */
+static int libperf_stat_add(const char *const list, struct libperf_stat_event *const events, size_t *const count)
+{
+	const char *start = list;
+	int in_terms = 0;
+	for (const char *cursor = list; ; ++cursor) {
+		if (*cursor == '/') {
+			in_terms = !in_terms;
+		}
+		if ((*cursor != ',' || in_terms) && *cursor != '\0') {
+			continue;
+		}
+
+		const size_t length = (size_t)(cursor - start);
+		if (length != 0) {
+			if (*count == LIBPERF_EVENT_CUSTOM_MAX || length >= LIBPERF_STAT_NAME) {
+				fprintf(stderr, "too many events, or event too long\n");
+				return -1;
+			}
+
+			struct libperf_stat_event *const event = &events[*count];
+			memset(event, 0, sizeof(*event));
+			memcpy(event->name, start, length);
+			event->name[length] = '\0';
+			if (libperf_stat_resolve(event->name, &event->attr) != 0) {
+				fprintf(stderr, "unknown event '%s'\n", event->name);
+				return -1;
+			}
+			++*count;
+		}
+
+		if (*cursor == '\0') {
+			return 0;
+		}
+		start = cursor + 1;
+	}
+}
+
+static void libperf_stat_accumulate(double *const mean, double *const m2, const uint64_t runs, const double value)
+{
+	const double delta = value - *mean;
+	*mean += delta / (double)runs;
+	*m2 += delta * (value - *mean);
+}
+
+static double libperf_stat_stddev(const double m2, const uint64_t runs)
+{
+	return runs > 1 ? sqrt(m2 / (double)(runs - 1)) : 0.0;
+}
+
+/**
+ * @brief libperf_stat_run - runs the command once, counting events over it
+ * @param char *const *const command - command & its arguments
+ * @param struct libperf_stat_event *const events - events to count, whose statistics are updated
+ * @param const size_t count - number of events
+ * @param const unsigned int flags - flags of libperf_init_explicit()
+ * @param struct libperf_stat_statistic *const wall - statistics of wall time to update
+ * @return int - exit status of command, or -1 if it couldn't be run
+ */
+static int libperf_stat_run(char *const *const command, struct libperf_stat_event *const events, const size_t count, const unsigned int flags, struct libperf_stat_statistic *const wall)
+{
+	int go[2]; // child waits on this until counters are opened
+	if (pipe(go) != 0) {
+		perror("pipe");
+		return -1;
+	}
+
+	const pid_t child = fork();
+	if (child < 0) {
+		perror("fork");
+		close(go[0]);
+		close(go[1]);
+		return -1;
+	} else if (child == 0) {
+		close(go[1]);
+		char byte;
+		if (read(go[0], &byte, 1) != 1) { // launcher gave up
+			_exit(127);
+		}
+		close(go[0]);
+		execvp(command[0], command);
+		perror(command[0]);
+		_exit(127);
+	}
+	close(go[0]);
+
+	struct perf_event_attr attrs[LIBPERF_EVENT_CUSTOM_MAX];
+	for (size_t i = 0; i < count; ++i) {
+		attrs[i] = events[i].attr;
+	}
+
+	libperf_tracker *const pd = libperf_init_explicit(child, -1, attrs, count, flags | LIBPERF_INIT_ENABLE_ON_EXEC);
+	if (pd == NULL) {
+		perror("unable to open counters");
+		close(go[1]);
+		kill(child, SIGKILL);
+		waitpid(child, NULL, 0);
+		return -1;
+	}
+
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	const char byte = 1;
+	const ssize_t released = write(go[1], &byte, 1);
+	close(go[1]);
+
+	int status = 0;
+	while (waitpid(child, &status, 0) < 0 && errno == EINTR);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	if (released != 1) {
+		libperf_fini(pd);
+		return -1;
+	}
+
+	wall->runs += 1;
+	libperf_stat_accumulate(&wall->mean, &wall->m2, wall->runs, (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec));
+
+	for (size_t i = 0; i < count; ++i) {
+		struct libperf_counter_value value;
+		if (libperf_read_counter_scaled(pd, LIBPERF_EVENT_CUSTOM_N(i), &value) != LIBPERF_EXIT_SUCCESS) { // unsupported here
+			continue;
+		}
+
+		events[i].runs += 1;
+		libperf_stat_accumulate(&events[i].mean, &events[i].m2, events[i].runs, (double)value.scaled);
+		events[i].running += value.time_enabled == 0 ? 1.0 : (double)value.time_running / (double)value.time_enabled;
+	}
+
+	libperf_fini(pd);
+
+	if (WIFSIGNALED(status)) {
+		return 128 + WTERMSIG(status);
+	}
+	return WEXITSTATUS(status);
+}
+
+/**
+ * @brief libperf_stat_json_string - writes a string out as a JSON string literal
+ * @param FILE *const output - output stream
+ * @param const char *const string - string
+ */
+static void libperf_stat_json_string(FILE *const output, const char *const string)
+{
+	fputc('"', output);
+	for (const unsigned char *c = (const unsigned char *)string; *c != '\0'; ++c) {
+		if (*c == '"' || *c == '\\') {
+			fprintf(output, "\\%c", *c);
+		} else if (*c < 0x20) {
+			fprintf(output, "\\u%04x", *c);
+		} else {
+			fputc(*c, output);
+		}
+	}
+	fputc('"', output);
+}
+
+static void libperf_stat_report(FILE *const output, const enum libperf_stat_format format, char *const *const command, const uint64_t runs, const struct libperf_stat_event *const events, const size_t count, const struct libperf_stat_statistic *const wall)
+{
+	switch (format) {
+		case LIBPERF_STAT_CSV:;
+			fprintf(output, "event,mean,stddev,runs,running\n");
+			for (size_t i = 0; i < count; ++i) {
+				const struct libperf_stat_event *const event = &events[i];
+				if (event->runs == 0) {
+					fprintf(output, "%s,,,0,\n", event->name);
+				} else {
+					fprintf(output, "%s,%.2f,%.2f,%lu,%.4f\n", event->name, event->mean, libperf_stat_stddev(event->m2, event->runs), event->runs, event->running / (double)event->runs);
+				}
+			}
+			fprintf(output, "WALL_TIME_NS,%.2f,%.2f,%lu,1.0000\n", wall->mean, libperf_stat_stddev(wall->m2, wall->runs), wall->runs);
+			break;
+		case LIBPERF_STAT_JSON:;
+			fprintf(output, "{\"command\":[");
+			for (char *const *argument = command; *argument != NULL; ++argument) {
+				if (argument != command) {
+					fputc(',', output);
+				}
+				libperf_stat_json_string(output, *argument);
+			}
+			fprintf(output, "],\"runs\":%lu,\"events\":[", runs);
+			for (size_t i = 0; i < count; ++i) {
+				const struct libperf_stat_event *const event = &events[i];
+				fprintf(output, "%s{\"event\":", i == 0 ? "" : ",");
+				libperf_stat_json_string(output, event->name);
+				if (event->runs == 0) {
+					fprintf(output, ",\"supported\":false}");
+				} else {
+					fprintf(output, ",\"supported\":true,\"mean\":%.2f,\"stddev\":%.2f,\"runs\":%lu,\"running\":%.4f}", event->mean, libperf_stat_stddev(event->m2, event->runs), event->runs, event->running / (double)event->runs);
+				}
+			}
+			fprintf(output, "],\"wall_time_ns\":{\"mean\":%.2f,\"stddev\":%.2f,\"runs\":%lu}}\n", wall->mean, libperf_stat_stddev(wall->m2, wall->runs), wall->runs);
+			break;
+		case LIBPERF_STAT_TEXT:;
+		default:;
+			fprintf(output, "\nCounter stats for '");
+			for (char *const *argument = command; *argument != NULL; ++argument) {
+				fprintf(output, "%s%s", argument == command ? "" : " ", *argument);
+			}
+			fprintf(output, "' (%lu runs):\n\n", runs);
+			for (size_t i = 0; i < count; ++i) {
+				const struct libperf_stat_event *const event = &events[i];
+				if (event->runs == 0) {
+					fprintf(output, "%20s  %s\n", "<not supported>", event->name);
+					continue;
+				}
+				fprintf(output, "%20.0f  %s", event->mean, event->name);
+				const int padding = 32 - (int)strlen(event->name); // align any annotations
+				if (event->runs > 1 && event->mean != 0.0) {
+					fprintf(output, "%*s ( +- %5.2f%% )", padding > 0 ? padding : 0, "", 100.0 * libperf_stat_stddev(event->m2, event->runs) / event->mean);
+				}
+				if (event->running < (double)event->runs) {
+					fprintf(output, " (counted %.2f%% of the time)", 100.0 * event->running / (double)event->runs);
+				}
+				fputc('\n', output);
+			}
+			fprintf(output, "\n%20.6f  seconds time elapsed", wall->mean / 1e9);
+			if (wall->runs > 1 && wall->mean != 0.0) {
+				fprintf(output, " ( +- %5.2f%% )", 100.0 * libperf_stat_stddev(wall->m2, wall->runs) / wall->mean);
+			}
+			fprintf(output, "\n\n");
+			break;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	static struct libperf_stat_event events[LIBPERF_EVENT_CUSTOM_MAX];
+	size_t count = 0;
+	unsigned long runs = 1;
+	unsigned int flags = LIBPERF_INIT_DEFAULT;
+	enum libperf_stat_format format = LIBPERF_STAT_TEXT;
+	const char *path = NULL;
+
+	libperf_set_diag_sink(NULL, NULL); // unsupported events are reported as such, rather than logged
+
+	int option;
+	while ((option = getopt(argc, argv, "+e:r:gcjo:h")) != -1) { // + stops at the command, leaving its options be
+		switch (option) {
+			case 'e':;
+				if (libperf_stat_add(optarg, events, &count) != 0) {
+					return EXIT_FAILURE;
+				}
+				break;
+			case 'r':;
+				char *end;
+				runs = strtoul(optarg, &end, 10);
+				if (end == optarg || *end != '\0' || runs == 0) {
+					usage(argv[0]);
+					return EXIT_FAILURE;
+				}
+				break;
+			case 'g':;
+				flags |= LIBPERF_INIT_GROUP;
+				break;
+			case 'c':;
+				format = LIBPERF_STAT_CSV;
+				break;
+			case 'j':;
+				format = LIBPERF_STAT_JSON;
+				break;
+			case 'o':;
+				path = optarg;
+				break;
+			default:;
+				usage(argv[0]);
+				return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (optind == argc) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+	char *const *const command = &argv[optind];
+
+	if (count == 0) {
+		for (size_t i = 0; i < sizeof(libperf_stat_defaults) / sizeof(libperf_stat_defaults[0]); ++i) {
+			struct libperf_stat_event *const event = &events[count++];
+			memset(event, 0, sizeof(*event));
+			snprintf(event->name, sizeof(event->name), "%s", libperf_event_name(libperf_stat_defaults[i]));
+			libperf_event_attr(libperf_stat_defaults[i], &event->attr);
+		}
+	}
+
+	FILE *output = stderr;
+	if (path != NULL && (output = fopen(path, "w")) == NULL) {
+		perror(path);
+		return EXIT_FAILURE;
+	}
+
+	struct libperf_stat_statistic wall = { 0, 0.0, 0.0 };
+	int status = EXIT_FAILURE;
+	for (unsigned long run = 0; run < runs; ++run) {
+		status = libperf_stat_run(command, events, count, flags, &wall);
+		if (status < 0) {
+			if (output != stderr) {
+				fclose(output);
+			}
+			return EXIT_FAILURE;
+		}
+	}
+
+	libperf_stat_report(output, format, command, wall.runs, events, count, &wall);
+
+	if (output != stderr) {
+		fclose(output);
+	}
+
+	return status;
+}